@@ -1,6 +1,22 @@
 #include "ResultAnalysis.h"
 #include "CSVReader/CSVReader2.h"
 
+#include <cfloat>
+#include <algorithm>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+typedef pair<float,float> PFF;
+
+/**
+ * @brief Order by result score only, GT scores may be NaN.
+ */
+static bool lessResultScore(const PFF &a, const PFF &b)
+{
+    return a.first < b.first;
+}
+
 
 bool ResultAnalysis::compare(const ResultData &gt, const ResultData &r,
                               StatisticResults &sr, vector<RAData> &ra)
@@ -59,10 +75,20 @@ bool ResultAnalysis::compare(const ResultData &gt, const ResultData &r,
     }
 }
 
-ResultAnalysis::ResultAnalysis()
+ResultAnalysis::ResultAnalysis():
+    nThreads(0), sweepGtChanges(0), sweepRChanges(0)
 {
 }
 
+/**
+ * @brief Set the number of threads of fromResults,
+ * 0 means one thread per hardware thread.
+ */
+void ResultAnalysis::setThreads(unsigned nThreads)
+{
+    this->nThreads = nThreads;
+}
+
 /**
  * @brief ResultAnalysis::process - Internal method that do the
  * comparison between results and compute the statistics results.
@@ -142,27 +168,127 @@ void ResultAnalysis::fromResults(const ResultData &gt, const ResultData &r,
         return;
     }
 
+    const vector<RData> &gd = gt.data,
+                        &rd = r.data;
+
     int gtParamChanges = (gtThEnd-gtThStart)/gtStep+1,
         rParamChanges = (rThEnd-rThStart)/rStep+1,
         size = (gtParamChanges)*(rParamChanges);
 
+    statisticResults.clear();
+    if(gtParamChanges <= 0 || rParamChanges <= 0)
+        return;
+
     statisticResults.resize((int) size);
     unsigned line=0;
-    float gtTh, rTh;
 
     for(int i = 0; i < gtParamChanges; i++)
     {
-        gtTh = gtThStart + i*gtStep; // This equation solve some precision issues
         for(int j = 0; j < rParamChanges; j++)
         {
-            rTh = rThStart + j*rStep;
             StatisticResults &sr = statisticResults[line];
-            sr.gTh = gtTh;
-            sr.rTh = rTh;
-            process(gt,r,sr);
+            sr.gTh = gtThStart + i*gtStep; // This equation solve some precision issues
+            sr.rTh = rThStart + j*rStep;
             line++;
         }
     }
+
+    // Pairs sorted by result score, same pairs of process()
+    vector<PFF> pairs;
+    pairs.reserve(gd.size());
+    for(unsigned i = 0 ; i < gd.size() && i < rd.size(); i++)
+    {
+        const RData &gdi = gd[i],
+                    &rdi = rd[i];
+
+        if(gdi.uId != rdi.uId || gdi.vId != rdi.vId)
+        {
+            cout << "ResultAnalysis::fromResults() - Probem with index! ("
+                 << gdi.uId << ',' << gdi.vId << ") != ("
+                 << rdi.uId << ',' << rdi.vId << ')' << endl;
+            continue;
+        }
+
+        // NaN is never positive, as on process()
+        float rScore = rdi.score == rdi.score ? rdi.score : -FLT_MAX;
+        pairs.push_back(PFF(rScore,gdi.score));
+    }
+    sort(pairs.begin(), pairs.end(), lessResultScore);
+
+    sweepR.resize(pairs.size());
+    sweepG.resize(pairs.size());
+    for(unsigned k = 0 ; k < pairs.size(); k++)
+    {
+        sweepR[k] = pairs[k].first;
+        sweepG[k] = pairs[k].second;
+    }
+
+    // Pairs after the cut of a result threshold are positives
+    sweepCuts.resize(rParamChanges);
+    for(int j = 0; j < rParamChanges; j++)
+    {
+        sweepCuts[j].first = upper_bound(sweepR.begin(), sweepR.end(),
+                                         statisticResults[j].rTh) - sweepR.begin();
+        sweepCuts[j].second = j;
+    }
+    sort(sweepCuts.begin(), sweepCuts.end());
+
+    sweepGtChanges = gtParamChanges;
+    sweepRChanges = rParamChanges;
+
+    unsigned nWorkers = nThreads;
+    if(nWorkers == 0)
+        nWorkers = max(1u, boost::thread::hardware_concurrency());
+    nWorkers = min(nWorkers, sweepGtChanges);
+
+    boost::thread_group workers;
+    for(unsigned w = 1 ; w < nWorkers; w++)
+        workers.create_thread(boost::bind(&ResultAnalysis::sweepGt,this,w,nWorkers));
+    sweepGt(0,nWorkers);
+    workers.join_all();
+
+    sweepR.clear();
+    sweepG.clear();
+    sweepCuts.clear();
+}
+
+/**
+ * @brief Compute the statistics of the ground truth thresholds
+ * worker, worker + nWorkers ... for all result thresholds.
+ */
+void ResultAnalysis::sweepGt(unsigned worker, unsigned nWorkers)
+{
+    unsigned n = sweepG.size();
+    const float *g = n > 0 ? &sweepG[0] : 0x0;
+
+    for(unsigned i = worker ; i < sweepGtChanges ; i+= nWorkers)
+    {
+        StatisticResults *srs = &statisticResults[i*sweepRChanges];
+        float gTh = srs[0].gTh;
+
+        // GT positives before each cut, they are the false negatives
+        unsigned positives = 0, k = 0;
+        for(unsigned c = 0 ; c < sweepCuts.size() ; c++)
+        {
+            unsigned cut = sweepCuts[c].first;
+            for(; k < cut ; k++)
+                positives+= g[k] > gTh;
+
+            StatisticResults &sr = srs[sweepCuts[c].second];
+            sr.fn = positives;
+            sr.tn = cut - positives;
+        }
+        for(; k < n ; k++)
+            positives+= g[k] > gTh;
+
+        for(unsigned j = 0 ; j < sweepRChanges ; j++)
+        {
+            StatisticResults &sr = srs[j];
+            unsigned cut = sr.fn + sr.tn;
+            sr.computeStatistics(positives - sr.fn, sr.tn,
+                                 (n - cut) - (positives - sr.fn), sr.fn);
+        }
+    }
 }
 
 bool ResultAnalysis::fromCSV(const char *csvFileName)
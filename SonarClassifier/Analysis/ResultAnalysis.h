@@ -20,16 +20,35 @@ public:
 /**
  * @brief The LoopClosureResultAnalysis class analyze
  *
+ *  fromResults() sweeps all thresholds at once, pairs are
+ * sorted by result score only one time, so each result threshold
+ * is a cut position on the sorted pairs and each ground truth
+ * threshold is one linear pass counting the positives before
+ * each cut. Ground truth thresholds are split between threads.
  */
 class ResultAnalysis
 {
+    typedef pair<unsigned,unsigned> PUU;
+
     vector<StatisticResults> statisticResults;
+
+    unsigned nThreads;
+
+    // Threshold sweep
+    vector<float> sweepR, sweepG; // Result and GT scores sorted by result score
+    vector<PUU> sweepCuts;        // (Pairs with result score <= rTh , rTh index) ascending
+    unsigned sweepGtChanges, sweepRChanges;
+
     bool compare(const ResultData &gt, const ResultData &r,
                  StatisticResults &sr, vector<RAData> &ra);
 
+    void sweepGt(unsigned worker, unsigned nWorkers);
+
 public:
     ResultAnalysis();
 
+    void setThreads(unsigned nThreads);
+
     bool process(const ResultData &gt, const ResultData &r,StatisticResults &sr);
 
     void fromResults(const ResultData &gt, const ResultData &r,
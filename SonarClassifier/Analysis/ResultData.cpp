@@ -1,4 +1,5 @@
 #include "ResultData.h"
+#include "CloseLoop/MatchResultStore.h"
 
 ResultData::ResultData()
 {
@@ -41,6 +42,51 @@ bool ResultData::fromCSV(const ResultData &baseIndex, const char *csvFileName)
     return true;
 }
 
+/**
+ * @brief Scores of the baseIndex pairs from a MatchResultStore
+ * (matchCount on LoopClosureEngine), pairs are searched in both
+ * orders and the missing ones score 0.
+ */
+bool ResultData::fromStore(const ResultData &baseIndex, const char *storeFileName)
+{
+    MatchResultStore rs;
+    if(!rs.open(storeFileName))
+        return false;
+
+    if(rs.minMatches() > 0)
+        cout << "ResultData warning: " << storeFileName << " was computed with MinMatches="
+             << rs.minMatches() << ", scores are only 0 or " << rs.minMatches() << endl;
+
+    data = baseIndex.data;
+    unsigned missing=0;
+    for(unsigned i = 0 ; i < data.size(); i++)
+    {
+        RData &d = data[i];
+        int k = rs.find(d.uId,d.vId);
+        if(k >= 0)
+        {
+            d.score = rs.score(d.uId)[k];
+            continue;
+        }
+
+        k = rs.find(d.vId,d.uId);
+        if(k >= 0)
+        {
+            d.score = rs.score(d.vId)[k];
+            continue;
+        }
+
+        d.score = 0.f;
+        missing++;
+    }
+
+    if(missing > 0)
+        cout << "ResultData: " << missing << " pairs not found on "
+             << storeFileName << endl;
+
+    return true;
+}
+
 bool ResultData::fromTriangularGreyImg(const char *img8BitFileName)
 {
     Mat result;
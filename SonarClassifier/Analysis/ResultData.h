@@ -33,6 +33,8 @@ public:
     bool fromCSV(const char *csvFileName);
     bool fromCSV(const ResultData &baseIndex, const char *csvFileName);
 
+    bool fromStore(const ResultData &baseIndex, const char *storeFileName);
+
     bool fromTriangularGreyImg(const char *img8BitFileName);
     bool fromTriangularGreyImg(const ResultData &baseIndex, const char *img8BitFileName);
 
@@ -52,6 +54,8 @@ public:
 //    rDeep.fromCSV(gt,"../../../../SonarGraphData/grayData/Pedro/DeepdevilABS_eval.csv");
 
 //    rSG.fromTriangularGreyImg(gt,"../../../../SonarGraphData/grayData/Pedro/ResultsGTLoop/ResultImage_New_tri.png");
+//    // or from the LoopClosureEngine ResultStore
+//    rSG.fromStore(gt,"../../../../SonarGraphData/grayData/Pedro/Results/LoopDetections/MatchResults.mrs");
 
 //    gt.toSquaredImgResult();
 //    rDeep.toSquaredImgResult();
@@ -0,0 +1,268 @@
+#include "FrameCandidateIndex.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+
+typedef pair<float,unsigned> PFU;
+
+FrameCandidateIndex::FrameCandidateIndex():
+    m_K(0), m_intensityBinSize(16.f), m_lengthBinSize(20.f)
+{
+}
+
+bool FrameCandidateIndex::load(ConfigLoader &config)
+{
+    bool gotSomeConfig=false;
+    float fv;
+    int iv;
+
+    if(config.getInt("FrameCandidateIndex","K",&iv))
+    {
+        m_K = max(iv,0);
+        gotSomeConfig=true;
+    }
+
+    if(config.getFloat("FrameCandidateIndex","intensityBinSize",&fv))
+    {
+        if(fv > 0.f) m_intensityBinSize = fv;
+        else cout << "FrameCandidateIndex warning: Invalid intensityBinSize!" << endl;
+        gotSomeConfig=true;
+    }
+
+    if(config.getFloat("FrameCandidateIndex","lengthBinSize",&fv))
+    {
+        if(fv > 0.f) m_lengthBinSize = fv;
+        else cout << "FrameCandidateIndex warning: Invalid lengthBinSize!" << endl;
+        gotSomeConfig=true;
+    }
+
+    return gotSomeConfig;
+}
+
+bool FrameCandidateIndex::enabled() const
+{
+    return m_K > 0;
+}
+
+unsigned FrameCandidateIndex::K() const
+{
+    return m_K;
+}
+
+void FrameCandidateIndex::setK(unsigned K)
+{
+    m_K = K;
+}
+
+/**
+ * @brief Compute the global descriptor of sd, each
+ * histogram sums 1 (or 0 if empty).
+ */
+void FrameCandidateIndex::describe(const SonarDescritor *sd, float *desc) const
+{
+    float *sizeH = desc,
+          *intensityH = desc + FCI_SIZE_BINS,
+          *lengthH = intensityH + FCI_INTENSITY_BINS;
+
+    fill(desc, desc + FCI_DIM, 0.f);
+
+    for(unsigned i = 0 ; i < sd->gaussians.size() ; i++)
+    {
+        const Gaussian &g = sd->gaussians[i];
+
+        unsigned sizeBin = 0;
+        for(unsigned n = g.N ; n > 1u ; n>>=1)
+            sizeBin++;
+        sizeH[min(sizeBin, FCI_SIZE_BINS-1u)]+= 1.f;
+
+        unsigned intensityBin = (unsigned) max(g.intensity/m_intensityBinSize, 0.f);
+        intensityH[min(intensityBin, FCI_INTENSITY_BINS-1u)]+= 1.f;
+    }
+
+    unsigned nEdges = 0;
+    for(unsigned v = 0 ; v < sd->graph.size() ; v++)
+    {
+        for(unsigned e = 0 ; e < sd->graph[v].size() ; e++)
+        {
+            unsigned lengthBin = (unsigned) max(sd->graph[v][e]->p/m_lengthBinSize, 0.f);
+            lengthH[min(lengthBin, FCI_LENGTH_BINS-1u)]+= 1.f;
+            nEdges++;
+        }
+    }
+
+    if(!sd->gaussians.empty())
+    {
+        float inv = 1.f/sd->gaussians.size();
+        for(unsigned b = 0 ; b < FCI_SIZE_BINS + FCI_INTENSITY_BINS ; b++)
+            desc[b]*= inv;
+    }
+
+    if(nEdges > 0)
+    {
+        float inv = 1.f/nEdges;
+        for(unsigned b = 0 ; b < FCI_LENGTH_BINS ; b++)
+            lengthH[b]*= inv;
+    }
+}
+
+/**
+ * @brief Describe the frames sd[0], sd[jump], sd[2*jump] ...
+ * index i of the index is frame i*jump (the LoopClosureEngine grid).
+ */
+void FrameCandidateIndex::build(const vector<SonarDescritor *> &sd, unsigned jump)
+{
+    if(jump == 0) jump = 1;
+
+    unsigned n = (sd.size() + jump - 1)/jump;
+
+    m_descriptors.assign(n*FCI_DIM, 0.f);
+    m_valid.assign(n, 0);
+
+    for(unsigned i = 0 ; i < n ; i++)
+    {
+        const SonarDescritor *sdi = sd[i*jump];
+        if(sdi == 0x0 || sdi->gaussians.empty())
+            continue;
+
+        describe(sdi, &m_descriptors[i*FCI_DIM]);
+        m_valid[i] = 1;
+    }
+}
+
+/**
+ * @brief Describe a new frame, its id is the index size before.
+ */
+unsigned FrameCandidateIndex::add(const SonarDescritor *sd)
+{
+    unsigned id = m_valid.size();
+
+    m_descriptors.resize((id+1)*FCI_DIM, 0.f);
+    m_valid.push_back(0);
+
+    if(sd != 0x0 && !sd->gaussians.empty())
+    {
+        describe(sd, &m_descriptors[id*FCI_DIM]);
+        m_valid[id] = 1;
+    }
+
+    return id;
+}
+
+void FrameCandidateIndex::clear()
+{
+    m_descriptors.clear();
+    m_valid.clear();
+}
+
+bool FrameCandidateIndex::isValid(unsigned id) const
+{
+    return id < m_valid.size() && m_valid[id];
+}
+
+unsigned FrameCandidateIndex::size() const
+{
+    return m_valid.size();
+}
+
+float FrameCandidateIndex::distance(unsigned a, unsigned b) const
+{
+    const float *da = &m_descriptors[a*FCI_DIM],
+                *db = &m_descriptors[b*FCI_DIM];
+
+    float d = 0.f;
+    for(unsigned k = 0 ; k < FCI_DIM ; k++)
+        d+= fabs(da[k] - db[k]);
+
+    return d;
+}
+
+/**
+ * @brief Candidate pairs (i , j) with j > i + windowGap.
+ * @param rowCandidates - rowCandidates[i] are the candidates j
+ * of frame i, ascending. Without K (disabled) all pairs are returned.
+ */
+void FrameCandidateIndex::candidates(unsigned windowGap,
+                                     vector<vector<unsigned> > &rowCandidates) const
+{
+    unsigned n = size();
+
+    rowCandidates.clear();
+    rowCandidates.resize(n);
+
+    if(!enabled())
+    {
+        for(unsigned i = 0 ; i < n ; i++)
+            for(unsigned j = i + windowGap + 1 ; j < n ; j++)
+                rowCandidates[i].push_back(j);
+        return;
+    }
+
+    vector<PFU> nearest;
+    nearest.reserve(n);
+
+    for(unsigned i = 0 ; i < n ; i++)
+    {
+        if(!m_valid[i]) continue;
+
+        // Frames out of the window, before and after i
+        nearest.clear();
+        for(unsigned j = 0 ; j < n ; j++)
+        {
+            if(!m_valid[j] || (j + windowGap >= i && j <= i + windowGap))
+                continue;
+            nearest.push_back(PFU(distance(i,j),j));
+        }
+
+        unsigned k = min(m_K, (unsigned) nearest.size());
+        partial_sort(nearest.begin(), nearest.begin() + k, nearest.end());
+
+        for(unsigned c = 0 ; c < k ; c++)
+        {
+            unsigned j = nearest[c].second;
+            if(j > i) rowCandidates[i].push_back(j);
+            else rowCandidates[j].push_back(i);
+        }
+    }
+
+    for(unsigned i = 0 ; i < n ; i++)
+    {
+        vector<unsigned> &row = rowCandidates[i];
+        sort(row.begin(), row.end());
+        row.erase(unique(row.begin(), row.end()), row.end());
+    }
+}
+
+/**
+ * @brief Frames with id lower than endId nearest to the frame
+ * query, the closest first. Up to K frames are returned, all of
+ * them without K.
+ */
+void FrameCandidateIndex::nearest(unsigned query, unsigned endId,
+                                  vector<unsigned> &ids) const
+{
+    ids.clear();
+
+    endId = min(endId, size());
+    if(!isValid(query)) return;
+
+    vector<PFU> ranked;
+    ranked.reserve(endId);
+    for(unsigned j = 0 ; j < endId ; j++)
+    {
+        if(m_valid[j] && j != query)
+            ranked.push_back(PFU(distance(query,j),j));
+    }
+
+    unsigned k = ranked.size();
+    if(m_K > 0 && m_K < k) k = m_K;
+    partial_sort(ranked.begin(), ranked.begin() + k, ranked.end());
+
+    for(unsigned c = 0 ; c < k ; c++)
+        ids.push_back(ranked[c].second);
+}
+
+bool FrameCandidateIndex::isCandidate(const vector<unsigned> &row, unsigned col)
+{
+    return binary_search(row.begin(), row.end(), col);
+}
@@ -0,0 +1,77 @@
+#ifndef FRAMECANDIDATEINDEX_H
+#define FRAMECANDIDATEINDEX_H
+
+#include <vector>
+
+#include "Sonar/SonarDescritor.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
+
+using namespace std;
+
+// Global descriptor layout, histograms of
+// Gaussian size (log2 of pixels), intensity and edge length
+#define FCI_SIZE_BINS 16u
+#define FCI_INTENSITY_BINS 16u
+#define FCI_LENGTH_BINS 32u
+#define FCI_DIM (FCI_SIZE_BINS + FCI_INTENSITY_BINS + FCI_LENGTH_BINS)
+
+/**
+ * @brief Nearest neighbour index of global frame descriptors,
+ * used to choose the frame pairs worth a full graph match.
+ *
+ *  Each frame is described by three normalised histograms (Gaussian
+ * size, Gaussian intensity and edge length), frames are compared by
+ * the L1 distance of their descriptors. Descriptors are kept on one
+ * contiguous matrix and searched linearly, it is cheap compared
+ * with a single graph match.
+ *
+ *  candidates() keeps, for each frame, its K nearest frames outside
+ * the time window. A pair is a candidate if one frame is on the
+ * K nearest of the other, so O(n.K) pairs are matched instead of
+ * O(n^2). When K is 0 (default) the index is disabled and all pairs
+ * are candidates.
+ *
+ *  Frames can also be added one by one (add), for online loop
+ * closure, and the nearest previous frames queried (nearest).
+ */
+class FrameCandidateIndex
+{
+    unsigned m_K;
+    float m_intensityBinSize, m_lengthBinSize;
+
+    vector<float> m_descriptors; // Frame i descriptor is [i*FCI_DIM , (i+1)*FCI_DIM)
+    vector<char> m_valid;        // Frames described with some Gaussian
+
+    void describe(const SonarDescritor *sd, float *desc) const;
+
+public:
+    FrameCandidateIndex();
+
+    bool load(ConfigLoader &config);
+
+    bool enabled() const;
+    unsigned K() const;
+    void setK(unsigned K);
+
+    void build(const vector<SonarDescritor*> &sd, unsigned jump=1);
+
+    unsigned add(const SonarDescritor *sd);
+
+    void clear();
+
+    unsigned size() const;
+
+    bool isValid(unsigned id) const;
+
+    float distance(unsigned a, unsigned b) const;
+
+    void candidates(unsigned windowGap,
+                    vector<vector<unsigned> > &rowCandidates) const;
+
+    void nearest(unsigned query, unsigned endId,
+                 vector<unsigned> &ids) const;
+
+    static bool isCandidate(const vector<unsigned> &row, unsigned col);
+};
+
+#endif // FRAMECANDIDATEINDEX_H
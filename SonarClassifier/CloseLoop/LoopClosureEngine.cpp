@@ -0,0 +1,453 @@
+#include "LoopClosureEngine.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+unsigned LoopClosureEngine::firstCol(unsigned row)
+{
+    return row + windowGap + 1;
+}
+
+void LoopClosureEngine::rowFileName(unsigned row, char *str)
+{
+    sprintf(str,(resultPath + "MatchResults_fr%04u.csv").c_str(),row*jump);
+}
+
+/**
+ * @brief Check if the results of a row are already
+ * on disk, from a previous run.
+ * @param rowMinMatches - MinMatches of the run that computed
+ * the row, from the CSV header (files without it are 0).
+ */
+bool LoopClosureEngine::rowComputed(unsigned row, unsigned &rowMinMatches)
+{
+    if(store.isOpen())
+    {
+        // Checked when the store was opened
+        rowMinMatches = minMatches;
+        return store.isDone(row*jump);
+    }
+
+    char str[300];
+    rowFileName(row,str);
+
+    FILE *f = fopen(str, "r");
+    if(f == 0x0)
+        return false;
+
+    rowMinMatches = 0;
+    if(fgets(str,sizeof(str),f) != 0x0)
+    {
+        const char *mode = strstr(str,"MinMatches=");
+        if(mode != 0x0)
+            sscanf(mode,"MinMatches=%u",&rowMinMatches);
+    }
+
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Build the tiles of all rows without results
+ * on disk and deal them round robin between the workers in row
+ * major order, so the first rows finish first and only a few
+ * rows are kept in memory at same time.
+ * @return false if there is nothing to compute or
+ * results on disk were computed with other MinMatches.
+ */
+bool LoopClosureEngine::createTiles()
+{
+    rowActive.clear();
+    rowActive.resize(nRows,0);
+    rowResults.clear();
+    rowResults.resize(nRows);
+    rowPending.clear();
+    rowPending.resize(nRows,0);
+    rowsDone = rowsTotal = 0;
+
+    unsigned lastColBlock = nCols > 0 ? (nCols-1)/tileSize : 0;
+
+    for(unsigned i = 0 ; i < nRows; i++)
+    {
+        unsigned row = firstRow + i;
+        unsigned rowMinMatches;
+        if(rowComputed(row,rowMinMatches))
+        {
+            // Counts of both runs can't be mixed
+            if(rowMinMatches != minMatches)
+            {
+                cout << "LoopClosureEngine: frame " << row*jump
+                     << " was computed with MinMatches=" << rowMinMatches
+                     << ", it can't be resumed with MinMatches=" << minMatches
+                     << "!" << endl;
+                return false;
+            }
+
+            #ifdef LOOPCLOSUREENGINE_DEBUG
+                cout << "LoopClosureEngine: frame " << row*jump << " already computed!!" << endl;
+            #endif
+            continue;
+        }
+
+        if(firstCol(row) >= nCols)
+        {
+            // Nothing to match, only the header is written
+            finishRow(row);
+            continue;
+        }
+
+        rowActive[i] = 1;
+        rowPending[i] = lastColBlock - firstCol(row)/tileSize + 1;
+        rowsTotal++;
+    }
+
+    unsigned w = 0, nTiles = 0;
+    for(unsigned rBeg = 0 ; rBeg < nRows ; rBeg+= tileSize)
+    {
+        unsigned rEnd = min(rBeg + tileSize, nRows);
+
+        // Skip row blocks already computed
+        bool hasWork = false;
+        for(unsigned i = rBeg; i < rEnd && !hasWork; i++)
+            hasWork = rowActive[i];
+        if(!hasWork) continue;
+
+        unsigned cb = firstCol(firstRow + rBeg)/tileSize;
+        for(; cb <= lastColBlock ; cb++)
+        {
+            queues[w]->tiles.push_back(
+                        PairTile(firstRow + rBeg, firstRow + rEnd,
+                                 cb*tileSize, min(cb*tileSize + tileSize, nCols)));
+            w = (w+1) % queues.size();
+            nTiles++;
+        }
+    }
+
+    cout << "LoopClosureEngine: "
+         << rowsTotal << " frames to process in "
+         << nTiles << " tiles with "
+         << queues.size() << " threads" << endl;
+
+    return nTiles > 0;
+}
+
+bool LoopClosureEngine::popTile(unsigned worker, PairTile &tile)
+{
+    {
+        TileDeque &q = *queues[worker];
+        boost::mutex::scoped_lock lock(q.mtx);
+        if(!q.tiles.empty())
+        {
+            tile = q.tiles.front();
+            q.tiles.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from the back of other workers queue
+    for(unsigned k = 1 ; k < queues.size() ; k++)
+    {
+        TileDeque &q = *queues[(worker + k) % queues.size()];
+        boost::mutex::scoped_lock lock(q.mtx);
+        if(!q.tiles.empty())
+        {
+            tile = q.tiles.back();
+            q.tiles.pop_back();
+            return true;
+        }
+    }
+
+    // Tiles are never created after start, so we are done
+    return false;
+}
+
+void LoopClosureEngine::processTile(unsigned worker, const PairTile &tile)
+{
+    GraphMatcher &gm = *matchers[worker];
+    vector<MatchInfo> vertexMatch;
+
+    for(unsigned row = tile.rBeg ; row < tile.rEnd ; row++)
+    {
+        unsigned i = row - firstRow,
+                 fc = firstCol(row),
+                 cBeg = max(tile.cBeg, fc);
+
+        if(!rowActive[i] || cBeg >= tile.cEnd)
+            continue;
+
+        // Results of the row are allocated when its first tile starts
+        unsigned *result;
+        {
+            boost::mutex::scoped_lock lock(rowMtx);
+            if(rowResults[i].empty())
+                rowResults[i].resize(nCols - fc,0);
+            result = &rowResults[i][0];
+        }
+
+        SonarDescritor *sdu = sd[row*jump];
+        for(unsigned col = cBeg ; col < tile.cEnd ; col++)
+        {
+            if(candidates.enabled() &&
+               !FrameCandidateIndex::isCandidate(rowCandidates[row],col))
+                continue;
+
+            if(minMatches > 0)
+            {
+                result[col - fc] = gm.hasMatches(sdu,sd[col*jump],minMatches) ? minMatches : 0;
+                continue;
+            }
+
+            vertexMatch.clear();
+            gm.findMatch(sdu,sd[col*jump],vertexMatch);
+            result[col - fc] = vertexMatch.size();
+        }
+
+        bool rowDone;
+        {
+            boost::mutex::scoped_lock lock(rowMtx);
+            rowDone = (--rowPending[i] == 0);
+        }
+
+        if(rowDone)
+            finishRow(row);
+    }
+}
+
+/**
+ * @brief Write the results of a row, it must be called
+ * only once per row, after all its tiles were processed.
+ */
+void LoopClosureEngine::finishRow(unsigned row)
+{
+    vector<unsigned> result;
+    unsigned i = row - firstRow;
+
+    {
+        boost::mutex::scoped_lock lock(rowMtx);
+        result.swap(rowResults[i]);
+    }
+
+    if(!writeRow(row,result))
+        return;
+
+    if(result.size() > 0)
+    {
+        boost::mutex::scoped_lock lock(rowMtx);
+        rowsDone++;
+        cout << "LoopClosureEngine: frame " << row*jump << " done ("
+             << rowsDone << " of " << rowsTotal << ")" << endl;
+    }
+}
+
+/**
+ * @brief Append the row on the result store, or write
+ * its CSV file without store.
+ */
+bool LoopClosureEngine::writeRow(unsigned row, const vector<unsigned> &result)
+{
+    unsigned fc = firstCol(row);
+
+    if(store.isOpen())
+    {
+        vector<unsigned> v(result.size());
+        for(unsigned k = 0 ; k < result.size() ; k++)
+            v[k] = (fc+k)*jump;
+
+        boost::mutex::scoped_lock lock(storeMtx);
+        return store.addRow(row*jump,v,result);
+    }
+
+    char str[300];
+    rowFileName(row,str);
+    FILE *f = fopen(str, "w");
+    if(f == 0x0)
+    {
+        boost::mutex::scoped_lock lock(rowMtx);
+        cout << "LoopClosureEngine: It was not possible to write on file " << str << endl;
+        return false;
+    }
+
+    fprintf(f,"#Src frame ID, Dst frame ID, Amout of similar vertex found between the frames, MinMatches=%u\n",
+            minMatches);
+    for(unsigned k = 0 ; k < result.size() ; k++)
+        fprintf(f,"%u,%u,%u\n",row*jump,(fc+k)*jump,result[k]);
+    fclose(f);
+
+    return true;
+}
+
+void LoopClosureEngine::worker(unsigned id)
+{
+    PairTile tile;
+    while(popTile(id,tile))
+        processTile(id,tile);
+}
+
+void LoopClosureEngine::clear()
+{
+    for(unsigned i = 0 ; i < queues.size(); i++)
+        delete queues[i];
+    queues.clear();
+
+    for(unsigned i = 0 ; i < matchers.size(); i++)
+        delete matchers[i];
+    matchers.clear();
+
+    rowActive.clear();
+    rowResults.clear();
+    rowPending.clear();
+    rowCandidates.clear();
+
+    if(store.isOpen())
+        store.close();
+}
+
+LoopClosureEngine::LoopClosureEngine(vector<SonarDescritor *> &sd,
+                                     const string &resultPath,
+                                     const char *configFileName):
+    sd(sd), resultPath(resultPath),
+    nThreads(0), tileSize(32), minMatches(0),
+    configFileName(configFileName),
+    jump(1), windowGap(0), firstRow(0), nRows(0), nCols(0),
+    rowsDone(0), rowsTotal(0)
+{
+    ConfigLoader config(configFileName);
+    load(config);
+}
+
+LoopClosureEngine::~LoopClosureEngine()
+{
+    clear();
+}
+
+void LoopClosureEngine::load(ConfigLoader &config)
+{
+    int iv;
+    string str;
+
+    if(config.getInt("CloseLoop","Threads",&iv))
+        setThreads(iv);
+
+    if(config.getInt("CloseLoop","TileSize",&iv))
+        setTileSize(iv);
+
+    if(config.getInt("CloseLoop","MinMatches",&iv))
+        minMatches = max(iv,0);
+
+    if(config.getString("CloseLoop","ResultStore",&str))
+    {
+        // ConfigLoader keeps the blanks before a line comment
+        while(!str.empty() && (str[str.size()-1] == ' ' || str[str.size()-1] == '\t'))
+            str.erase(str.size()-1);
+        resultStore = str;
+    }
+
+    candidates.load(config);
+
+    // Those vertex matchers sort the descriptor's edges
+    // in place, so descriptors can't be shared between threads.
+    if(config.getString("General","VertexMatcher",&str) &&
+       (str == "VMScalenePC" || str == "VMWeghtedSumPC"))
+    {
+        cout << "LoopClosureEngine warning: " << str
+             << " changes the descriptors, using only one thread!" << endl;
+        nThreads = 1;
+    }
+}
+
+/**
+ * @brief Set the number of workers, 0 means one
+ * worker per hardware thread.
+ */
+void LoopClosureEngine::setThreads(unsigned nThreads)
+{
+    this->nThreads = nThreads;
+}
+
+void LoopClosureEngine::setTileSize(unsigned tileSize)
+{
+    if(tileSize > 0)
+        this->tileSize = tileSize;
+    else
+        cout << "LoopClosureEngine warning: Invalid tile size!" << endl;
+}
+
+/**
+ * @brief Match every described frame u in [start,end) against
+ * all frames v > u + windowJump, using same frame selection of
+ * CloseLoopTester::computeMatchs.
+ */
+void LoopClosureEngine::compute(unsigned jump, unsigned windowJump,
+                                unsigned start, unsigned end)
+{
+    if(jump == 0) jump = 1;
+    if(end == 0 || end > sd.size()) end = sd.size();
+
+    windowJump = windowJump - windowJump%jump;
+    start = start - start%jump;
+
+    this->jump = jump;
+    windowGap = windowJump/jump;
+    firstRow = start/jump;
+    nCols = (sd.size() + jump - 1)/jump;
+    nRows = start < end ? (end - start + jump - 1)/jump : 0;
+
+    unsigned nWorkers = nThreads;
+    if(nWorkers == 0)
+        nWorkers = max(1u, boost::thread::hardware_concurrency());
+
+    clear();
+    for(unsigned i = 0 ; i < nWorkers; i++)
+        queues.push_back(new TileDeque);
+
+    if(!resultStore.empty() &&
+       !store.open((resultPath + resultStore).c_str(), sd.size(), minMatches))
+    {
+        clear();
+        return;
+    }
+
+    if(!createTiles())
+    {
+        clear();
+        return;
+    }
+
+    if(candidates.enabled())
+    {
+        candidates.build(sd,jump);
+        candidates.candidates(windowGap,rowCandidates);
+
+        unsigned long long nPairs=0, nCandidates=0;
+        for(unsigned row = firstRow ; row < firstRow + nRows ; row++)
+        {
+            if(firstCol(row) < nCols)
+                nPairs+= nCols - firstCol(row);
+            nCandidates+= rowCandidates[row].size();
+        }
+
+        cout << "LoopClosureEngine: " << nCandidates << " candidate pairs of "
+             << nPairs << " (K = " << candidates.K() << ")" << endl;
+    }
+
+    ConfigLoader config(configFileName.c_str());
+    for(unsigned i = 0 ; i < nWorkers; i++)
+        matchers.push_back(new GraphMatcher(config));
+
+    boost::thread_group workers;
+    for(unsigned i = 0 ; i < nWorkers; i++)
+        workers.create_thread(boost::bind(&LoopClosureEngine::worker,this,i));
+    workers.join_all();
+
+    SignatureMetrics metrics;
+    for(unsigned i = 0 ; i < matchers.size(); i++)
+        metrics.add(matchers[i]->m_gmf->signatures.metrics);
+    metrics.print();
+
+    clear();
+}
@@ -0,0 +1,131 @@
+#ifndef LOOPCLOSUREENGINE_H
+#define LOOPCLOSUREENGINE_H
+
+// ===== DEBUG ===========
+// #define LOOPCLOSUREENGINE_DEBUG
+// ==== END DEBUG ========
+
+#include <vector>
+#include <deque>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+
+#include "Sonar/SonarDescritor.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
+#include "GraphMatcher/GraphMatcher.h"
+#include "CloseLoop/FrameCandidateIndex.h"
+#include "CloseLoop/MatchResultStore.h"
+
+using namespace std;
+
+/**
+ * @brief A rectangular block of the upper triangular
+ * frame pair matrix. Rows and columns are grid
+ * indexes (frame number / jump).
+ */
+class PairTile
+{
+public:
+    PairTile(unsigned rBeg=0, unsigned rEnd=0,
+             unsigned cBeg=0, unsigned cEnd=0):
+        rBeg(rBeg), rEnd(rEnd), cBeg(cBeg), cEnd(cEnd){}
+
+    unsigned rBeg, rEnd, // Rows [rBeg, rEnd)
+             cBeg, cEnd; // Columns [cBeg, cEnd)
+};
+
+/**
+ * @brief Work queue of one worker. The owner takes
+ * tiles from the front, thieves take from the back.
+ */
+class TileDeque
+{
+public:
+    deque<PairTile> tiles;
+    boost::mutex mtx;
+};
+
+/**
+ * @brief Multi-threaded all pairs loop closure.
+ *  The pair matrix (u,v) with v > u + windowJump is split in
+ * square tiles that are distributed between workers, idle workers
+ * steal tiles from the others. Each worker owns its GraphMatcher,
+ * because the graph match finders keep state between calls
+ * (e.g. GMFHungarian::hu).
+ *  Results keep the CloseLoopTester file layout, one
+ * MatchResults_fr%04u.csv per source frame, that is written when
+ * the last tile of that row finishes. Rows with a result file
+ * already on disk are skipped, so an interrupted run can be resumed.
+ *  With a ResultStore file name, all rows are appended to a single
+ * MatchResultStore instead, and rows already on the store are skipped.
+ *  With a FrameCandidateIndex K, only the candidate pairs are
+ * matched, the others are written with 0 similar vertex.
+ *  With MinMatches, pairs are only tested for at least MinMatches
+ * similar vertex (GraphMatcher::hasMatches), positive pairs are
+ * written with MinMatches and negative pairs with 0, so results
+ * are only valid for a detection threshold of MinMatches. MinMatches
+ * is saved on the CSV header and on the store, a run is only resumed
+ * with the same MinMatches.
+ */
+class LoopClosureEngine
+{
+protected:
+    vector<SonarDescritor*> &sd;
+    string resultPath;
+
+    unsigned nThreads, tileSize,
+             minMatches; // 0 computes the full match
+    string configFileName,
+           resultStore; // Store file name on resultPath, empty writes CSV files
+
+    // Pair grid
+    unsigned jump, windowGap, firstRow, nRows, nCols;
+
+    // Candidate pre-filter, rowCandidates[row] are the columns matched
+    FrameCandidateIndex candidates;
+    vector<vector<unsigned> > rowCandidates;
+
+    // Workers
+    vector<TileDeque*> queues;
+    vector<GraphMatcher*> matchers;
+
+    // Row bookkeeping
+    vector<char> rowActive;
+    vector<vector<unsigned> > rowResults;
+    vector<unsigned> rowPending;
+    boost::mutex rowMtx;
+    unsigned rowsDone, rowsTotal;
+
+    MatchResultStoreWriter store;
+    boost::mutex storeMtx;
+
+    unsigned firstCol(unsigned row);
+    void rowFileName(unsigned row, char *str);
+    bool rowComputed(unsigned row, unsigned &rowMinMatches);
+    bool writeRow(unsigned row, const vector<unsigned> &result);
+
+    bool createTiles();
+    bool popTile(unsigned worker, PairTile &tile);
+    void processTile(unsigned worker, const PairTile &tile);
+    void finishRow(unsigned row);
+    void worker(unsigned id);
+
+    void clear();
+
+public:
+    LoopClosureEngine(vector<SonarDescritor*> &sd,
+                      const string &resultPath,
+                      const char *configFileName);
+    ~LoopClosureEngine();
+
+    void load(ConfigLoader &config);
+
+    void setThreads(unsigned nThreads);
+    void setTileSize(unsigned tileSize);
+
+    void compute(unsigned jump, unsigned windowJump,
+                 unsigned start=0, unsigned end=0);
+};
+
+#endif // LOOPCLOSUREENGINE_H
@@ -0,0 +1,445 @@
+#include "MatchResultStore.h"
+
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef pair<unsigned,unsigned> PUU;
+
+/**
+ * @brief FNV-1a over 32 bits words, all store records
+ * are multiple of 4 bytes.
+ */
+static unsigned mrsChecksum(const void *data, size_t size, unsigned h=2166136261u)
+{
+    const unsigned *w = (const unsigned*) data;
+    for(size_t i = 0 ; i < size/4 ; i++)
+    {
+        h^= w[i];
+        h*= 16777619u;
+    }
+    return h;
+}
+
+static unsigned mrsChunkChecksum(const MRSChunk &chunk, const void *columns)
+{
+    MRSChunk c = chunk;
+    c.checksum = 0;
+    unsigned h = mrsChecksum(&c,sizeof(c));
+    return mrsChecksum(columns, c.count*(2*sizeof(unsigned) + sizeof(float)), h);
+}
+
+static bool mrsValidChunk(const MRSChunk &chunk, unsigned nFrames)
+{
+    return memcmp(chunk.magic,MRS_CHUNK_MAGIC,4) == 0 &&
+           chunk.u < nFrames && chunk.count <= nFrames;
+}
+
+// ====== MatchResultStoreWriter =======
+
+MatchResultStoreWriter::MatchResultStoreWriter():
+    f(0x0), nFrames(0), minMatches(0)
+{
+}
+
+MatchResultStoreWriter::~MatchResultStoreWriter()
+{
+    if(f != 0x0)
+        close();
+}
+
+/**
+ * @brief Read the chunks already on the file to rebuild the
+ * completion bitmap, the file is truncated after the last
+ * valid chunk.
+ */
+bool MatchResultStoreWriter::recover(const char *fileName)
+{
+    long long pos = sizeof(MRSHeader);
+    MRSChunk chunk;
+    vector<char> columns;
+    unsigned nChunks = 0;
+
+    while(fread(&chunk,sizeof(chunk),1,f) == 1 &&
+          mrsValidChunk(chunk,nFrames))
+    {
+        columns.resize(chunk.count*(2*sizeof(unsigned) + sizeof(float)) + 1);
+        if(fread(&columns[0],1,columns.size()-1,f) != columns.size()-1 ||
+           mrsChunkChecksum(chunk,&columns[0]) != chunk.checksum)
+            break;
+
+        done[chunk.u/8]|= 1u << (chunk.u%8);
+        pos+= sizeof(chunk) + columns.size()-1;
+        nChunks++;
+    }
+
+    fseek(f,0,SEEK_END);
+    if(ftell(f) != pos)
+    {
+        cout << "MatchResultStoreWriter: Discarding broken chunk at the end of "
+             << fileName << endl;
+        if(fflush(f) != 0 || ftruncate(fileno(f),pos) != 0)
+        {
+            cout << "MatchResultStoreWriter: It was not possible to truncate "
+                 << fileName << endl;
+            return false;
+        }
+    }
+
+    // Appends go to the end of the valid chunks
+    return fseek(f,pos,SEEK_SET) == 0;
+}
+
+/**
+ * @brief Open a store to append results, the store is
+ * created if it does not exist.
+ * @param nFrames - Frame ids are lower than it, an existing
+ * store must have the same value.
+ * @param minMatches - Counts are only 0 or minMatches (0 for full
+ * counts), an existing store must have the same value.
+ */
+bool MatchResultStoreWriter::open(const char *fileName, unsigned nFrames, unsigned minMatches)
+{
+    if(f != 0x0)
+        close();
+
+    this->nFrames = nFrames;
+    this->minMatches = minMatches;
+    done.clear();
+    done.resize((nFrames+7)/8,0);
+
+    MRSHeader header;
+
+    f = fopen(fileName, "r+b");
+    if(f != 0x0)
+    {
+        if(fread(&header,sizeof(header),1,f) != 1 ||
+           memcmp(header.magic,MRS_MAGIC,4) != 0 ||
+           header.version != MRS_VERSION)
+        {
+            cout << "MatchResultStoreWriter: Invalid or incompatible store " << fileName << endl;
+            fclose(f);
+            f = 0x0;
+            return false;
+        }
+
+        if(header.nFrames != nFrames)
+        {
+            cout << "MatchResultStoreWriter: Store " << fileName << " has "
+                 << header.nFrames << " frames instead of " << nFrames << endl;
+            fclose(f);
+            f = 0x0;
+            return false;
+        }
+
+        if(header.minMatches != minMatches)
+        {
+            cout << "MatchResultStoreWriter: Store " << fileName << " was computed with minMatches "
+                 << header.minMatches << " instead of " << minMatches << endl;
+            fclose(f);
+            f = 0x0;
+            return false;
+        }
+
+        if(!recover(fileName))
+        {
+            fclose(f);
+            f = 0x0;
+            return false;
+        }
+        return true;
+    }
+
+    f = fopen(fileName, "w+b");
+    if(f == 0x0)
+    {
+        cout << "MatchResultStoreWriter: It was not possible to open file " << fileName << endl;
+        return false;
+    }
+
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,MRS_MAGIC,4);
+    header.version = MRS_VERSION;
+    header.nFrames = nFrames;
+    header.minMatches = minMatches;
+
+    if(fwrite(&header,sizeof(header),1,f) != 1 ||
+       fflush(f) != 0 || fsync(fileno(f)) != 0)
+    {
+        cout << "MatchResultStoreWriter: Write error on file " << fileName << endl;
+        fclose(f);
+        f = 0x0;
+        return false;
+    }
+
+    return true;
+}
+
+bool MatchResultStoreWriter::close()
+{
+    if(f == 0x0) return false;
+
+    bool ok = fclose(f) == 0;
+    f = 0x0;
+
+    if(!ok)
+        cout << "MatchResultStoreWriter: Store wasn't closed correctly!" << endl;
+
+    return ok;
+}
+
+bool MatchResultStoreWriter::isOpen() const
+{
+    return f != 0x0;
+}
+
+bool MatchResultStoreWriter::isDone(unsigned u) const
+{
+    return u < nFrames && (done[u/8] & (1u << (u%8)));
+}
+
+unsigned MatchResultStoreWriter::numberOfDone() const
+{
+    unsigned n = 0;
+    for(unsigned u = 0 ; u < nFrames ; u++)
+        if(isDone(u)) n++;
+    return n;
+}
+
+/**
+ * @brief Append the results of the source frame u, the
+ * chunk is on disk when it returns.
+ * @param score - Same size of v or empty, if empty
+ * the score is the matchCount.
+ */
+bool MatchResultStoreWriter::addRow(unsigned u, const vector<unsigned> &v,
+                                    const vector<unsigned> &matchCount,
+                                    const vector<float> &score)
+{
+    if(f == 0x0)
+    {
+        cout << "MatchResultStoreWriter: Store not opened!" << endl;
+        return false;
+    }
+
+    unsigned n = v.size();
+    if(u >= nFrames || n > nFrames || matchCount.size() != n ||
+       (!score.empty() && score.size() != n))
+    {
+        cout << "MatchResultStoreWriter: Invalid results of frame " << u << endl;
+        return false;
+    }
+
+    if(isDone(u))
+    {
+        cout << "MatchResultStoreWriter: Frame " << u << " already stored!" << endl;
+        return false;
+    }
+
+    // Columns sorted by v
+    vector<PUU> order(n);
+    for(unsigned k = 0 ; k < n ; k++)
+        order[k] = PUU(v[k],k);
+    sort(order.begin(), order.end());
+
+    vector<unsigned> columns(3*n);
+    unsigned *cv = columns.empty() ? 0x0 : &columns[0],
+             *cm = cv + n;
+    float *cs = (float*) (cm + n);
+
+    for(unsigned k = 0 ; k < n ; k++)
+    {
+        unsigned i = order[k].second;
+        cv[k] = v[i];
+        cm[k] = matchCount[i];
+        cs[k] = score.empty() ? (float) matchCount[i] : score[i];
+    }
+
+    MRSChunk chunk;
+    memcpy(chunk.magic,MRS_CHUNK_MAGIC,4);
+    chunk.u = u;
+    chunk.count = n;
+    chunk.checksum = mrsChunkChecksum(chunk,cv);
+
+    if(fwrite(&chunk,sizeof(chunk),1,f) != 1 ||
+       fwrite(cv,sizeof(unsigned),columns.size(),f) != columns.size() ||
+       fflush(f) != 0 || fsync(fileno(f)) != 0)
+    {
+        cout << "MatchResultStoreWriter: Write error on frame " << u << endl;
+        return false;
+    }
+
+    done[u/8]|= 1u << (u%8);
+    return true;
+}
+
+// ====== MatchResultStore =======
+
+MatchResultStore::MatchResultStore():
+    fd(-1), data(0x0), size(0),
+    header(0x0), nRows(0)
+{
+}
+
+MatchResultStore::~MatchResultStore()
+{
+    close();
+}
+
+bool MatchResultStore::open(const char *fileName)
+{
+    close();
+
+    fd = ::open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        cout << "MatchResultStore: File " << fileName << " not found" << endl;
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(fd,&st) != 0 || (size_t) st.st_size < sizeof(MRSHeader))
+    {
+        cout << "MatchResultStore: Invalid file " << fileName << endl;
+        close();
+        return false;
+    }
+    size = st.st_size;
+
+    void *p = mmap(0x0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p == MAP_FAILED)
+    {
+        cout << "MatchResultStore: mmap failed on file " << fileName << endl;
+        data = 0x0;
+        close();
+        return false;
+    }
+    data = (const char*) p;
+    header = (const MRSHeader*) data;
+
+    if(memcmp(header->magic,MRS_MAGIC,4) != 0 ||
+       header->version != MRS_VERSION)
+    {
+        cout << "MatchResultStore: Invalid or incompatible store " << fileName << endl;
+        close();
+        return false;
+    }
+
+    madvise((void*) data, size, MADV_SEQUENTIAL);
+
+    // Index the chunks, a broken one ends the store
+    rows.assign(header->nFrames,0x0);
+    size_t pos = sizeof(MRSHeader);
+    while(pos + sizeof(MRSChunk) <= size)
+    {
+        const MRSChunk *chunk = (const MRSChunk*) (data + pos);
+        if(!mrsValidChunk(*chunk,header->nFrames))
+            break;
+
+        size_t end = pos + sizeof(MRSChunk) +
+                chunk->count*(2*sizeof(unsigned) + sizeof(float));
+        if(end > size || mrsChunkChecksum(*chunk,chunk+1) != chunk->checksum)
+            break;
+
+        if(rows[chunk->u] == 0x0)
+        {
+            rows[chunk->u] = chunk;
+            nRows++;
+        }
+        pos = end;
+    }
+
+    if(pos != size)
+        cout << "MatchResultStore: Ignoring broken chunk at the end of " << fileName << endl;
+
+    madvise((void*) data, size, MADV_RANDOM);
+
+    return true;
+}
+
+void MatchResultStore::close()
+{
+    if(data != 0x0)
+        munmap((void*) data, size);
+    if(fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    data = 0x0;
+    size = 0;
+    header = 0x0;
+    rows.clear();
+    nRows = 0;
+}
+
+bool MatchResultStore::isOpen() const
+{
+    return header != 0x0;
+}
+
+unsigned MatchResultStore::numberOfFrames() const
+{
+    return header != 0x0 ? header->nFrames : 0;
+}
+
+/**
+ * @brief Amount of source frames with results.
+ */
+unsigned MatchResultStore::numberOfRows() const
+{
+    return nRows;
+}
+
+/**
+ * @brief Counts are only 0 or minMatches when it is
+ * not 0 (early exit match), instead of full counts.
+ */
+unsigned MatchResultStore::minMatches() const
+{
+    return header != 0x0 ? header->minMatches : 0;
+}
+
+bool MatchResultStore::isDone(unsigned u) const
+{
+    return u < rows.size() && rows[u] != 0x0;
+}
+
+unsigned MatchResultStore::rowSize(unsigned u) const
+{
+    return isDone(u) ? rows[u]->count : 0;
+}
+
+const unsigned *MatchResultStore::v(unsigned u) const
+{
+    return isDone(u) ? (const unsigned*) (rows[u]+1) : 0x0;
+}
+
+const unsigned *MatchResultStore::matchCount(unsigned u) const
+{
+    return isDone(u) ? v(u) + rows[u]->count : 0x0;
+}
+
+const float *MatchResultStore::score(unsigned u) const
+{
+    return isDone(u) ? (const float*) (matchCount(u) + rows[u]->count) : 0x0;
+}
+
+/**
+ * @brief Position of pair (u , v) on the row of u.
+ * @return int - -1 if not found.
+ */
+int MatchResultStore::find(unsigned u, unsigned v) const
+{
+    const unsigned *begin = this->v(u);
+    if(begin == 0x0) return -1;
+
+    const unsigned *end = begin + rows[u]->count,
+                   *it = lower_bound(begin,end,v);
+
+    return it != end && *it == v ? it - begin : -1;
+}
@@ -0,0 +1,131 @@
+#ifndef MATCHRESULTSTORE_H
+#define MATCHRESULTSTORE_H
+
+#include <vector>
+#include <cstdio>
+
+using namespace std;
+
+/*
+ *  Binary match result store layout (native endianness):
+ *
+ *  MRSHeader
+ *  For each finished source frame u, in completion order:
+ *      MRSChunk
+ *      unsigned v[count]           (ascending)
+ *      unsigned matchCount[count]
+ *      float score[count]
+ *
+ *  Chunks are only appended, each one is flushed and synced
+ * before the next, a chunk with wrong checksum (e.g. a crash
+ * while writing it) ends the store.
+ */
+
+#define MRS_MAGIC "SMRS"
+#define MRS_CHUNK_MAGIC "MRSC"
+#define MRS_VERSION 1u
+
+struct MRSHeader
+{
+    char magic[4];
+    unsigned version;
+    unsigned nFrames;    /**< Frame ids are lower than nFrames */
+    unsigned minMatches; /**< >0 if counts are only 0 or minMatches (LoopClosureEngine MinMatches) */
+};
+
+struct MRSChunk
+{
+    char magic[4];
+    unsigned u;        /**< Source frame id */
+    unsigned count;    /**< Pairs of the chunk */
+    unsigned checksum; /**< Of the chunk header (checksum 0) and columns */
+};
+
+/**
+ * @brief Append only writer of the match result store.
+ *  open() keeps the chunks already on the file, so an
+ * interrupted run is resumed asking isDone() for each frame,
+ * a broken chunk at the end is truncated, a store is only
+ * resumed with the same nFrames and minMatches. Methods aren't
+ * thread safe.
+ */
+class MatchResultStoreWriter
+{
+    FILE *f;
+    unsigned nFrames, minMatches;
+    vector<unsigned char> done; // Completion bitmap
+
+    bool recover(const char *fileName);
+
+public:
+    MatchResultStoreWriter();
+    ~MatchResultStoreWriter();
+
+    bool open(const char *fileName, unsigned nFrames, unsigned minMatches=0);
+    bool close();
+    bool isOpen() const;
+
+    bool isDone(unsigned u) const;
+    unsigned numberOfDone() const;
+
+    bool addRow(unsigned u, const vector<unsigned> &v,
+                const vector<unsigned> &matchCount,
+                const vector<float> &score=vector<float>());
+};
+
+/**
+ * @brief Read only memory mapped match result store.
+ *  Opening scans the chunk headers only, columns of a
+ * frame are read directly from the mapped file.
+ */
+class MatchResultStore
+{
+    int fd;
+    const char *data;
+    size_t size;
+
+    const MRSHeader *header;
+    vector<const MRSChunk*> rows; // rows[u], 0x0 if not done
+    unsigned nRows;
+
+public:
+    MatchResultStore();
+    ~MatchResultStore();
+
+    bool open(const char *fileName);
+    void close();
+    bool isOpen() const;
+
+    unsigned numberOfFrames() const;
+    unsigned numberOfRows() const;
+    unsigned minMatches() const;
+
+    bool isDone(unsigned u) const;
+
+    // Columns of frame u, sorted by v
+    unsigned rowSize(unsigned u) const;
+    const unsigned *v(unsigned u) const;
+    const unsigned *matchCount(unsigned u) const;
+    const float *score(unsigned u) const;
+
+    int find(unsigned u, unsigned v) const;
+};
+
+/*
+// Some tests
+#include "CloseLoop/MatchResultStore.h"
+
+int main(int argc, char* argv[])
+{
+    MatchResultStore rs;
+    if(!rs.open("Results/LoopDetections/MatchResults.mrs")) return 1;
+
+    for(unsigned u = 0 ; u < rs.numberOfFrames(); u++)
+        for(unsigned k = 0 ; k < rs.rowSize(u); k++)
+            cout << u << "," << rs.v(u)[k] << "," << rs.matchCount(u)[k] << endl;
+
+    return 0;
+}
+*/
+
+#endif // MATCHRESULTSTORE_H
@@ -0,0 +1,150 @@
+#include "OnlineLoopClosure.h"
+#include "Cronometer.h"
+
+#include <iostream>
+#include <algorithm>
+
+OnlineLoopClosure::OnlineLoopClosure(const char *configFileName):
+    sink(0x0), ownDescriptors(true),
+    windowJump(0), K(0), minSimilarVertex(1), budget(0.f),
+    matchedPairs(0), skippedPairs(0),
+    totalTime(0.0), maxTime(0.0)
+{
+    ConfigLoader config(configFileName);
+    gm.load(config);
+    index.load(config);
+    load(config);
+}
+
+OnlineLoopClosure::~OnlineLoopClosure()
+{
+    clear();
+}
+
+void OnlineLoopClosure::load(ConfigLoader &config)
+{
+    int iv;
+    float fv;
+
+    if(config.getInt("OnlineLoopClosure","windowJump",&iv))
+        windowJump = max(iv,0);
+
+    if(config.getInt("OnlineLoopClosure","K",&iv))
+        K = max(iv,0);
+
+    if(config.getInt("OnlineLoopClosure","minSimilarVertex",&iv))
+        minSimilarVertex = max(iv,0);
+
+    if(config.getFloat("OnlineLoopClosure","budget",&fv))
+        budget = max(fv,0.f);
+
+    index.setK(K);
+}
+
+void OnlineLoopClosure::setSink(OnlineLoopSink *sink)
+{
+    this->sink = sink;
+}
+
+void OnlineLoopClosure::setOwnDescriptors(bool ownDescriptors)
+{
+    this->ownDescriptors = ownDescriptors;
+}
+
+/**
+ * @brief Match a new frame against the history, the loops
+ * found are sent to the sink before it returns.
+ * @param sd - New frame, it may be 0x0 (frame without description).
+ * @return unsigned - Id of the new frame.
+ */
+unsigned OnlineLoopClosure::push(SonarDescritor *sd)
+{
+    Cronometer cron;
+
+    unsigned id = history.size();
+    history.push_back(sd);
+    index.add(sd);
+
+    unsigned matched = 0, skipped = 0;
+
+    // Frames out of the window, the nearest first
+    if(id > windowJump)
+        index.nearest(id, id - windowJump, nearest);
+    else
+        nearest.clear();
+
+    for(unsigned k = 0 ; k < nearest.size() ; k++)
+    {
+        if(budget > 0.f && cron.read()/1000.0 >= budget)
+        {
+            skipped = nearest.size() - k;
+            break;
+        }
+
+        unsigned u = nearest[k];
+
+        // Same frame order of the batch mode
+        vertexMatch.clear();
+        gm.findMatch(history[u], sd, vertexMatch);
+        matched++;
+
+        if(vertexMatch.size() >= minSimilarVertex && sink != 0x0)
+            sink->newLoop(LoopCandidate(u, id, vertexMatch.size()));
+    }
+
+    double ms = cron.read()/1000.0;
+    matchedPairs+= matched;
+    skippedPairs+= skipped;
+    totalTime+= ms;
+    maxTime = max(maxTime, ms);
+
+    if(sink != 0x0)
+        sink->frameDone(id, matched, skipped, ms);
+
+    return id;
+}
+
+unsigned OnlineLoopClosure::size() const
+{
+    return history.size();
+}
+
+SonarDescritor *OnlineLoopClosure::frame(unsigned id)
+{
+    return id < history.size() ? history[id] : 0x0;
+}
+
+/**
+ * @brief Forget all frames, the statistics are reset.
+ */
+void OnlineLoopClosure::clear()
+{
+    if(ownDescriptors)
+    {
+        for(unsigned i = 0 ; i < history.size() ; i++)
+            delete history[i];
+    }
+    history.clear();
+    index.clear();
+
+    matchedPairs = skippedPairs = 0;
+    totalTime = maxTime = 0.0;
+}
+
+void OnlineLoopClosure::printStatistics() const
+{
+    cout << "OnlineLoopClosure: " << history.size() << " frames, "
+         << matchedPairs << " pairs matched, "
+         << skippedPairs << " skipped by budget, "
+         << (history.empty() ? 0.0 : totalTime/history.size())
+         << " ms per frame (max " << maxTime << " ms)" << endl;
+}
+
+/**
+ * @brief FramePipeline frames arrive in input order, the
+ * frame ids of both are the same.
+ */
+void OnlineLoopClosure::newFrame(unsigned id, const string &fileName, SonarDescritor *sd)
+{
+    push(sd);
+}
@@ -0,0 +1,118 @@
+#ifndef ONLINELOOPCLOSURE_H
+#define ONLINELOOPCLOSURE_H
+
+#include <vector>
+#include <string>
+
+#include "Sonar/SonarDescritor.h"
+#include "Sonar/FramePipeline.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
+#include "GraphMatcher/GraphMatcher.h"
+#include "CloseLoop/FrameCandidateIndex.h"
+
+using namespace std;
+
+/**
+ * @brief A loop found by the OnlineLoopClosure, same
+ * values of a line of the batch MatchResults files.
+ */
+class LoopCandidate
+{
+public:
+    LoopCandidate(unsigned srcId=0, unsigned dstId=0, unsigned similarVertex=0):
+        srcId(srcId), dstId(dstId), similarVertex(similarVertex){}
+
+    unsigned srcId,         // Older frame
+             dstId,         // New frame
+             similarVertex; // Amount of similar vertex found between the frames
+};
+
+/**
+ * @brief Receive the loops of OnlineLoopClosure while the frames
+ * are pushed, on the thread that pushes them.
+ */
+class OnlineLoopSink
+{
+public:
+    virtual ~OnlineLoopSink(){}
+
+    virtual void newLoop(const LoopCandidate &loop) = 0;
+
+    /**
+     * @brief Called after each frame is processed.
+     * @param matched - Frame pairs matched by the GraphMatcher.
+     * @param skipped - Candidate pairs left by the latency budget.
+     * @param ms - Time spent on the frame.
+     */
+    virtual void frameDone(unsigned id, unsigned matched, unsigned skipped, double ms){}
+};
+
+/**
+ * @brief Loop closure of a live stream of frames.
+ *  Each pushed frame is matched against the previous ones as
+ * it arrives, with the same GraphMatcher and windowJump exclusion
+ * of the batch mode (CloseLoopTester::computeMatchs), so frame v
+ * is matched with frames u < v - windowJump and results are the
+ * same of the batch mode on those pairs. Frame ids are the push
+ * order.
+ *
+ *  Past frames are kept on an incremental FrameCandidateIndex and
+ * matched from the nearest to the farthest, only the K nearest
+ * (all without K). The budget (ms) bounds the time of each frame,
+ * the remained candidates are skipped when it ends, the last match
+ * may finish after it.
+ *  The nearest frames are found by a linear scan of the whole
+ * history (FrameCandidateIndex::nearest), so the cost of each
+ * pushed frame grows linearly with the history, even with K.
+ *  Pairs with at least minSimilarVertex similar vertex are
+ * sent to the OnlineLoopSink.
+ *
+ *  It is also a FramePipelineSink, so a FramePipeline can
+ * feed it directly.
+ *  Pushed descriptors are kept as history and deleted with it,
+ * unless setOwnDescriptors(false) (e.g. descriptors from a
+ * DescriptorArena).
+ */
+class OnlineLoopClosure : public FramePipelineSink
+{
+protected:
+    GraphMatcher gm;
+    FrameCandidateIndex index;
+    OnlineLoopSink *sink;
+
+    vector<SonarDescritor*> history;
+    bool ownDescriptors;
+
+    unsigned windowJump, K, minSimilarVertex;
+    float budget; // ms, 0 is unlimited
+
+    // Statistics
+    unsigned long long matchedPairs, skippedPairs;
+    double totalTime, maxTime; // ms
+
+    vector<unsigned> nearest;
+    vector<MatchInfo> vertexMatch;
+
+public:
+    OnlineLoopClosure(const char *configFileName);
+    ~OnlineLoopClosure();
+
+    void load(ConfigLoader &config);
+
+    void setSink(OnlineLoopSink *sink);
+    void setOwnDescriptors(bool ownDescriptors);
+
+    unsigned push(SonarDescritor *sd);
+
+    unsigned size() const;
+    SonarDescritor *frame(unsigned id);
+
+    void clear();
+
+    void printStatistics() const;
+
+    // FramePipelineSink interface
+    void newFrame(unsigned id, const string &fileName, SonarDescritor *sd);
+};
+
+#endif // ONLINELOOPCLOSURE_H
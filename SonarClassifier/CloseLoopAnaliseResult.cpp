@@ -1,4 +1,6 @@
 #include "CloseLoopAnaliseResult.h"
+#include "CloseLoop/MatchResultStore.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
 #include <cstdio>
 #include <iostream>
 
@@ -95,6 +97,39 @@ void CloseLoopAnaliseResult::loadResultOfMatch(const char *prefix)
     }
 }
 
+/**
+ * @brief Same of loadResultOfMatch, from the
+ * MatchResultStore of LoopClosureEngine.
+ * @return false if the store was not found or is invalid.
+ */
+bool CloseLoopAnaliseResult::loadResultOfMatchStore(const char *storeFileName)
+{
+    MatchResultStore rs;
+    if(!rs.open((destPath + storeFileName).c_str()))
+        return false;
+
+    resultGraph.clear();
+    cout << "Loading match results from " << storeFileName << endl;
+
+    if(rs.minMatches() > 0)
+        cout << "Warning: results computed with MinMatches=" << rs.minMatches()
+             << ", counts are only 0 or " << rs.minMatches() << endl;
+
+    unsigned nFrs= frResults.size();
+    resultGraph.resize(nFrs);
+
+    for(unsigned u =0 ; u < nFrs && u < rs.numberOfFrames() ; u++)
+    {
+        unsigned n = rs.rowSize(u);
+        const unsigned *v = rs.v(u);
+        const float *score = rs.score(u);
+
+        resultGraph[u].reserve(n);
+        for(unsigned k = 0 ; k < n ; k++)
+            resultGraph[u].push_back(PUF(v[k],score[k]));
+    }
+    return true;
+}
 
 void CloseLoopAnaliseResult::loadDirectResult(const char *csvFileName, unsigned nFrames)
 {
@@ -326,14 +361,37 @@ void CloseLoopAnaliseResult::saveSplitedGTResults()
     }
 }
 
-void CloseLoopAnaliseResult::loadAnalisyAndSave()
+/**
+ * @brief Load the results and the ground truth, then save
+ * the analisy.
+ * @param configFileName - Config of the LoopClosureEngine run,
+ * its [CloseLoop] ResultStore is read instead of the CSV files.
+ */
+void CloseLoopAnaliseResult::loadAnalisyAndSave(const char *configFileName)
 {
     // ====== Results stuffs ========
     // Load Frame Descriptions Statistcs
     loadFrameDescriptionInformation("Results/ResultFramesInformations.csv");
 
-    // Load Frame Matchs
-    loadResultOfMatch("Results/LoopDetections/MatchResults_fr");
+    // Load Frame Matchs, from the LoopClosureEngine ResultStore if it was used
+    ConfigLoader config(configFileName);
+    string resultStore;
+    if(config.getString("CloseLoop","ResultStore",&resultStore))
+    {
+        // ConfigLoader keeps the blanks before a line comment
+        while(!resultStore.empty() &&
+              (resultStore[resultStore.size()-1] == ' ' || resultStore[resultStore.size()-1] == '\t'))
+            resultStore.erase(resultStore.size()-1);
+    }
+
+    if(resultStore.empty())
+        loadResultOfMatch("Results/LoopDetections/MatchResults_fr");
+    else if(!loadResultOfMatchStore(("Results/LoopDetections/" + resultStore).c_str()))
+    {
+        cout << "Warning: Result store " << resultStore
+             << " can't be loaded, falling back to the CSV result files" << endl;
+        loadResultOfMatch("Results/LoopDetections/MatchResults_fr");
+    }
 
     // Normalize Results
 //    normalizeResult();
@@ -34,6 +34,7 @@ private:
 
     void loadFrameDescriptionInformation(const char *fileName= "Results/ResultFramesInformations.csv");
     void loadResultOfMatch(const char *prefix="Results/LoopDetections/MatchResults_fr");
+    bool loadResultOfMatchStore(const char *storeFileName="Results/LoopDetections/MatchResults.mrs");
     void loadDirectResult(const char *csvFileName, unsigned nFrames);
 
     void loadGtMatch(const char *gtFileName="GTMatchs.csv");
@@ -56,7 +57,7 @@ public:
     void saveSplitedGTResults(unsigned uFr);
     void saveSplitedGTResults();
 
-    void loadAnalisyAndSave();
+    void loadAnalisyAndSave(const char *configFileName="../SonarGaussian/Configs.ini");
 
     void saveAnalisyResults(const char *fileName= "CompareResult.csv");
 
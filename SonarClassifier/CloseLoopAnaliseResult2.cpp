@@ -1,5 +1,6 @@
 #include "CloseLoopAnaliseResult2.h"
 #include "CSVReader/CSVReader2.h"
+#include "CloseLoop/MatchResultStore.h"
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
@@ -24,7 +25,13 @@ void CloseLoopAnaliseResult2::process(const char *csvGTName, const char *csvResu
         cout << "Problem to load " << csvGTName << endl;
         return;
     }
-    loadResults((workPath+csvResultName).c_str());
+    // MatchResultStore (.mrs) or CSV with one score per GT line
+    string resultName(csvResultName);
+    if(resultName.size() > 4 &&
+       resultName.compare(resultName.size()-4,4,".mrs") == 0)
+        loadResultsFromStore((workPath+resultName).c_str());
+    else
+        loadResults((workPath+resultName).c_str());
 
     generateGTImage();
     generateResultImage();
@@ -81,6 +88,50 @@ bool CloseLoopAnaliseResult2::loadResults(const char *csvFileName)
     return true;
 }
 
+/**
+ * @brief Load the scores of the GT pairs from a
+ * MatchResultStore, pairs are searched in both orders,
+ * the missing ones score 0.
+ */
+bool CloseLoopAnaliseResult2::loadResultsFromStore(const char *storeFileName)
+{
+    MatchResultStore rs;
+    if(!rs.open(storeFileName))
+        return false;
+
+    if(rs.minMatches() > 0)
+        cout << "CloseLoopAnaliseResult2 warning: " << storeFileName << " was computed with MinMatches="
+             << rs.minMatches() << ", scores are only 0 or " << rs.minMatches() << endl;
+
+    unsigned missing=0;
+    for(unsigned i = 0 ; i < data.size(); i++)
+    {
+        CLR2Data &d = data[i];
+        int k = rs.find(d.uId,d.vId);
+        if(k >= 0)
+        {
+            d.rScore = rs.score(d.uId)[k];
+            continue;
+        }
+
+        k = rs.find(d.vId,d.uId);
+        if(k >= 0)
+        {
+            d.rScore = rs.score(d.vId)[k];
+            continue;
+        }
+
+        d.rScore = 0.f;
+        missing++;
+    }
+
+    if(missing > 0)
+        cout << "CloseLoopAnaliseResult2: " << missing << " GT pairs not found on "
+             << storeFileName << endl;
+
+    return true;
+}
+
 bool CloseLoopAnaliseResult2::loadResultsFromTriangGreyImage(const char *img8BitFileName)
 {
     Mat result;
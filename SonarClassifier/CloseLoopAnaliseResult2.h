@@ -35,6 +35,7 @@ public:
     bool loadGT(const char *csvFileName);
 
     bool loadResults(const char *csvFileName);
+    bool loadResultsFromStore(const char *storeFileName);
     bool loadResultsFromTriangGreyImage(const char *img8BitFileName);
     bool loadFeaturesCountFromTriangGreyImage(const char *img8BitFileName);
 
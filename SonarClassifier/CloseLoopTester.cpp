@@ -1,4 +1,15 @@
 #include "CloseLoopTester.h"
+#include "CloseLoop/LoopClosureEngine.h"
+#include "CloseLoop/FrameCandidateIndex.h"
+#include "CloseLoop/OnlineLoopClosure.h"
+#include "Sonar/DescriptorArchive.h"
+#include "Sonar/FramePipeline.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
+#include "GraphMatcher/VertexMatcher/VMHeuristicByAngVariation.h"
+#include "Cronometer.h"
+
+#include <cstring>
+#include <algorithm>
 
 CloseLoopTester::CloseLoopTester(const string &datasetPath, unsigned jump):
     datasetPath(datasetPath), jump(jump)
@@ -32,174 +43,330 @@ bool CloseLoopTester::loadFrames(const char *fileName)
     return true;
 }
 
-void CloseLoopTester::describeFrames()
+/**
+ * @brief Store the descriptors delivered by the FramePipeline
+ * on CloseLoopTester and write the frame informations CSV.
+ */
+class DescribeFramesSink : public FramePipelineSink
 {
-    // Creating Sonar objects to describe frames
-    ConfigLoader config("../SonarGaussian/Configs.ini");
-    Sonar sonar(config,false);
-    sonar.storeImgs = false;
-    sonar.drawPixelFound = false;
+public:
+    DescribeFramesSink(vector<SonarDescritor*> &sd, unsigned jump, FILE *f):
+        sd(sd), jump(jump), f(f){}
+
+    vector<SonarDescritor*> &sd;
+    unsigned jump;
+    FILE *f;
+
+    void newFrame(unsigned id, const string &fileName, SonarDescritor *csd)
+    {
+        unsigned i = id*jump;
+        cout << "Described frame " << i << " " << fileName << endl;
+        sd[i] = csd;
 
+        if(f)
+            fprintf(f, "%u,%lu,%u\n",i,csd->gaussians.size(),csd->numberOfEdges()/2);
+    }
+};
+
+void CloseLoopTester::describeFrames()
+{
     FILE *f = fopen((datasetPath + "Results/ResultFramesInformations.csv").c_str(), "w");
 
     if(f)
-        cout << "Saving results in " << (datasetPath + "Results/LoopDetections/ResultFramesInformations.csv") << endl;
+    {
+        cout << "Saving results in " << (datasetPath + "Results/ResultFramesInformations.csv") << endl;
+        fprintf(f,"# Frame ID, Amount of vertices, Amount of edges\n");
+    }
     else
-        cout << "It was not possible to open write on file " << (datasetPath + "Results/LoopDetections/ResultFramesInformations.csv")
+        cout << "It was not possible to open write on file " << (datasetPath + "Results/ResultFramesInformations.csv")
              << endl;
 
-    fprintf(f,"# Frame ID, Amount of vertices, Amount of edges\n");
-
-    sd.resize(frames.size());
+    // Descriptors of previous batch are released together
+    arena.reset();
+    sd.assign(frames.size(),0x0);
 
+    vector<string> fileNames;
     for(unsigned i = 0 ;i < frames.size() ; i+=jump)
-    {
-        unsigned frNumber = frames[i].frameNumber;
-        cout << "Describing frame " << frNumber << endl;
-        Mat img = imread(frames[i].fileName.c_str(),CV_LOAD_IMAGE_ANYDEPTH);
-        SonarDescritor *csd = sonar.newImageDirect(img);
-        sd[i] = csd;
+        fileNames.push_back(frames[i].fileName);
 
-        fprintf(f, "%u,%lu,%u\n",i,csd->gaussians.size(),csd->numberOfEdges()/2);
-    }
-    fclose(f);
+    FramePipeline pipeline("../SonarGaussian/Configs.ini");
+    pipeline.setDescriptorArena(&arena);
+    DescribeFramesSink sink(sd,jump,f);
+    pipeline.run(fileNames,sink);
+
+    if(f)
+        fclose(f);
 }
 
+/**
+ * @brief Save all frame descriptions on a binary
+ * descriptor archive (see DescriptorArchive).
+ */
 void CloseLoopTester::saveDescriptions(const char *fileName)
 {
-    #ifdef GROUND_TRUTH_TRACKING_DEBUG
-        cout << "GroundTruth:saveGroundTruth:: use!" << endl;
-    #endif
+    DescriptorArchiveWriter writer;
+    if(!writer.open(fileName))
+        return;
 
-    setlocale (LC_ALL,"C");
-    FILE *f = fopen(fileName, "w");
-    if(f == 0x0)
-        cout << "File " << fileName << " not found" << endl;
+    for(unsigned frame = 0 ; frame < frames.size() ; frame++)
+    {
+        SonarDescritor *sdi = frame < sd.size() ? sd[frame] : 0x0;
+        if(!writer.addFrame(sdi, frames[frame].fileName, frames[frame].frameNumber))
+            break;
+    }
 
-    unsigned frame=0, g;
+    writer.close();
+}
 
-    fprintf(f,"%u\n", frames.size());
-    for(frame = 0 ; frame < frames.size() ; frame++)
-    {
-        Frame &fr = frames[frame];
-        SonarDescritor *sdi = sd[frame];
+/**
+ * @brief Load the frames and its descriptions from a
+ * binary descriptor archive.
+ */
+void CloseLoopTester::loadDescriptions(const char *fileName)
+{
+    DescriptorArchive archive;
+    if(!archive.open(fileName))
+        return;
 
-        // Frame description
-        // Image filename frameID NumberOfGaussians
-        fprintf(f,"%s %u %u\n", fr.fileName.c_str() , frame, sdi->gaussians.size());
+    unsigned nFrames = archive.numberOfFrames();
 
-        // Gaussians Description
-        vector<Gaussian> &gs = sdi->gaussians;
-        if(gs.size() == 0) continue;
+    arena.reset();
 
-        for(g = 0 ; g < gs.size(); g++)
-        {
-            Gaussian &ga = gs[g];
-            // ID X, Y, Z , DX, DY, DZ, Ang, N
-            fprintf(f,"%d %f %f %f %f %f %f %f %u\n", g, ga.x, ga.y , ga.intensity, ga.dx , ga.dy, ga.di, ga.ang , ga.N );
-        }
+    frames.clear();
+    frames.reserve(nFrames);
+    sd.clear();
+    sd.resize(nFrames,0x0);
 
-        // Graph description
-        vector<vector<GraphLink*> > &graph = sdi->graph;
-        for(unsigned i = 0; i < graph.size() ; i++)
+    // All frames are decoded now, each frame is matched against
+    // all others (computeMatchs, computeMatchsOnline) so decoding
+    // on each access would cost more than the whole archive once
+    for(unsigned frame = 0 ; frame < nFrames ; frame++)
+    {
+        frames.push_back(Frame(archive.frameFileName(frame),
+                               archive.frameNumber(frame)));
+        if(!archive.isEmpty(frame))
         {
-            for(unsigned j = 0 ; j < graph[i].size() ; j++)
-            {
-                GraphLink *link = graph[i][j];
-                // float ang, p , rang, invang, int dest
-                fprintf(f,"%f %f %f %f %d\n", link->ang, link->p, link->rAng, link->invAngle, link->dest);
-            }
+            sd[frame] = arena.newDescriptor();
+
+            // Corrupted frames are handled as not described
+            if(!archive.loadFrame(frame,sd[frame]))
+                sd[frame] = 0x0;
         }
     }
-    fclose(f);
 }
 
-void CloseLoopTester::loadDescriptions(const char *fileName)
+void CloseLoopTester::computeMatchs(unsigned windowJump, unsigned start, unsigned end)
 {
-    #ifdef GROUND_TRUTH_TRACKING_DEBUG
-        cout << "GroundTruth:saveGroundTruth:: use!" << endl;
-    #endif
+    cout << "Computing matchs" << endl;
 
-    setlocale (LC_ALL,"C");
-    FILE *f = fopen(fileName, "r");
-    if(f == 0x0)
-        cout << "File " << fileName << " not found" << endl;
+    LoopClosureEngine engine(sd, datasetPath + "Results/LoopDetections/",
+                             "../SonarGaussian/Configs.ini");
 
-    unsigned nFrames, nGaussians;
-    char str[400];
+    engine.compute(jump,windowJump,start,end);
+}
 
-    fscanf(f,"%u\n", &nFrames);
-    frames.resize(nFrames,Frame("",0));
-    sd.resize(nFrames);
+/**
+ * @brief Write the loops of OnlineLoopClosure with the
+ * line format of the batch result files.
+ */
+class OnlineMatchsSink : public OnlineLoopSink
+{
+public:
+    OnlineMatchsSink(FILE *f, unsigned jump):
+        f(f), jump(jump){}
 
-    for(unsigned frame = 0 ; frame < nFrames ; frame++)
+    FILE *f;
+    unsigned jump;
+
+    void newLoop(const LoopCandidate &loop)
     {
-        Frame &fr = frames[frame];
-        SonarDescritor *sdi = sd[frame];
+        fprintf(f,"%u,%u,%u\n",loop.srcId*jump,loop.dstId*jump,loop.similarVertex);
+    }
+};
+
+/**
+ * @brief Replay the described frames on OnlineLoopClosure, as
+ * they would arrive from the sonar. Loops are saved on
+ * Results/LoopDetections/OnlineMatchResults.csv, the windowJump
+ * is read from [OnlineLoopClosure] section (in pushed frames).
+ *  Results are comparable with computeMatchs only with K=0 and
+ * no budget, otherwise only some pairs are matched.
+ */
+void CloseLoopTester::computeMatchsOnline()
+{
+    string fileName = datasetPath + "Results/LoopDetections/OnlineMatchResults.csv";
+    FILE *f = fopen(fileName.c_str(), "w");
+    if(f == 0x0)
+    {
+        cout << "It was not possible to open write on file " << fileName << endl;
+        return;
+    }
+    fprintf(f,"#Src frame ID, Dst frame ID, Amout of similar vertex found between the frames\n");
 
-        // Frame description
-        // Image filename frameID NumberOfGaussians
-        fscanf(f,"%s %*u %u\n", str , &nGaussians);
-        fr.fileName = str;
+    OnlineLoopClosure olc("../SonarGaussian/Configs.ini");
+    OnlineMatchsSink sink(f,jump);
+    olc.setSink(&sink);
+    olc.setOwnDescriptors(false); // sd belongs to the arena
 
-        if(nGaussians == 0) continue;
+    for(unsigned i = 0 ; i < sd.size() ; i+=jump)
+        olc.push(sd[i]);
 
-        // Gaussians Description
-        vector<Gaussian> &gs = sdi->gaussians;
-        gs.resize(nGaussians);
+    olc.printStatistics();
+    fclose(f);
+}
 
-        for(unsigned g = 0 ; g < nGaussians; g++)
-        {
-            Gaussian &ga = gs[g];
-            // ID X, Y, Z , DX, DY, DZ, Ang, N
-            fscanf(f,"%*d %f %f %f %f %f %f %f %u\n", &ga.x, &ga.y , &ga.intensity, &ga.dx,
-                    &ga.dy, &ga.di, &ga.ang , &ga.N );
-        }
+/**
+ * @brief Compare VMHeuristicByAngVariation with and without edge
+ * signatures (SonarDescritor::edgesByLength) on all vertex pairs of
+ * frame pairs windowJump apart. Results must be identical, the time
+ * of both is reported.
+ */
+void CloseLoopTester::benchmarkVertexMatcher(unsigned windowJump, unsigned nPairs)
+{
+    ConfigLoader config("../SonarGaussian/Configs.ini");
+    VMHeuristicByAngVariation vm;
+    vm.load(config);
 
-        // Graph description
-        vector<vector<GraphLink*> > &graph = sdi->graph;
-        for(unsigned i = 0; i < graph.size() ; i++)
+    Cronometer cron;
+    double scanTime=0.0, signatureTime=0.0;
+    unsigned long vertexPairs=0, mismatches=0;
+    unsigned testedPairs=0;
+
+    for(unsigned i = 0 ; i + windowJump < sd.size() && testedPairs < nPairs ; i+=jump)
+    {
+        SonarDescritor *u = sd[i], *v = sd[i+windowJump];
+        if(u == 0x0 || v == 0x0) continue;
+
+        unsigned nU = u->graph.size(), nV = v->graph.size();
+        vector<float> scanError(nU*nV), signatureError(nU*nV);
+        vector<unsigned> scanMatch(nU*nV,0), signatureMatch(nU*nV,0);
+
+        cron.reset();
+        for(unsigned a = 0 ; a < nU ; a++)
+            for(unsigned b = 0 ; b < nV ; b++)
+                scanError[a*nV+b] = vm.vertexMatch(u->gaussians[a],v->gaussians[b],
+                                                   u->graph[a],v->graph[b],
+                                                   &scanMatch[a*nV+b]);
+        scanTime+= cron.reset();
+
+        for(unsigned a = 0 ; a < nU ; a++)
+            for(unsigned b = 0 ; b < nV ; b++)
+                signatureError[a*nV+b] = vm.vertexMatch(u->gaussians[a],v->gaussians[b],
+                                                        u->graph[a],v->graph[b],
+                                                        u->edgesByLength(a),v->edgesByLength(b),
+                                                        &signatureMatch[a*nV+b]);
+        signatureTime+= cron.reset();
+
+        for(unsigned k = 0 ; k < nU*nV ; k++)
         {
-            for(unsigned j = 0 ; j < graph[i].size() ; j++)
-            {
-                GraphLink *link = graph[i][j];
-                // float ang, p , rang, invang, int dest
-                fscanf(f,"%f %f %f %f %d\n", &link->ang, &link->p, &link->rAng, &link->invAngle, &link->dest);
-            }
+            if(scanMatch[k] != signatureMatch[k] ||
+               memcmp(&scanError[k],&signatureError[k],sizeof(float)) != 0)
+                mismatches++;
         }
+        vertexPairs+= nU*nV;
+        testedPairs++;
     }
-    fclose(f);
+
+    cout << "Vertex matcher benchmark: " << testedPairs << " frame pairs, "
+         << vertexPairs << " vertex pairs, " << mismatches << " mismatches" << endl
+         << "Edge scan " << scanTime/1000.0 << " ms , edge signatures "
+         << signatureTime/1000.0 << " ms , speed-up "
+         << (signatureTime > 0.0 ? scanTime/signatureTime : 0.0) << "x" << endl;
 }
 
-void CloseLoopTester::computeMatchs(unsigned windowJump, unsigned start, unsigned end)
+/**
+ * @brief Recall of the FrameCandidateIndex pre-filter against a
+ * loop ground truth (GTLoop CSV: header line, then source frame,
+ * destination frame, score). Ground truth pairs with score greater
+ * than minScore, out of windowJump and with both frames described
+ * are loops, for several K it reports the fraction of pairs kept and
+ * of loops kept. The report is also saved on Results/CandidateRecall.csv
+ *  Frames and window are the ones of LoopClosureEngine::compute with
+ * the tester jump, only ground truth loops between frames of that grid
+ * are evaluated.
+ */
+void CloseLoopTester::candidateRecall(const char *gtFileName, unsigned windowJump, float minScore)
 {
-    cout << "Computing matchs" << endl;
-    ConfigLoader config("../SonarGaussian/Configs.ini");
-    GraphMatcher gm(config);
-    char str[300];
+    FILE *f = fopen((datasetPath + gtFileName).c_str(),"r");
+    if(f == 0x0)
+    {
+        cout << "CloseLoopTester: Ground truth file " << gtFileName << " not found!" << endl;
+        return;
+    }
 
-    if(end == 0) end = sd.size();
-    windowJump =  windowJump - windowJump%jump;
-    for(unsigned u =start - start%jump ; u < end ; u+=jump)
+    // Dicard header line
+    fscanf(f, "%*[^\n]\n");
+
+    // Same grid of LoopClosureEngine::compute, pairs are index (frame/jump)
+    unsigned windowGap = (windowJump - windowJump%jump)/jump,
+             nCols = (sd.size() + jump - 1)/jump;
+
+    unsigned src, dst;
+    float score;
+    vector<pair<unsigned,unsigned> > loops;
+    while(fscanf(f,"%u,%u,%g", &src, &dst, &score) == 3)
     {
-        cout << "Processing frame " << u << " until " << end << " " << jump << " in " << jump << endl;
-        sprintf(str,(datasetPath + "Results/LoopDetections/MatchResults_fr%04u.csv").c_str(),u);
-        FILE *f = fopen(str, "r");
-        if(f != 0x0)
-        {
-            cout << "Already computed!!" << endl;
-            fclose(f);
+        if(src > dst) swap(src,dst);
+        if(score <= minScore || dst >= sd.size() ||
+           src%jump != 0 || dst%jump != 0 ||
+           dst/jump - src/jump <= windowGap ||
+           sd[src] == 0x0 || sd[dst] == 0x0)
             continue;
-        }
-        f = fopen(str, "w");
+        loops.push_back(pair<unsigned,unsigned>(src/jump,dst/jump));
+    }
+    fclose(f);
 
-        fprintf(f,"#Src frame ID, Dst frame ID, Amout of similar vertex found between the frames\n");
-        for(unsigned v = u + windowJump+jump ; v < sd.size() ; v+=jump)
-        {
-            vector<MatchInfo> vertexMatch;
-            gm.findMatch(sd[u],sd[v],vertexMatch);
-            fprintf(f,"%u,%u,%lu\n",u,v,vertexMatch.size());
-        }
-        fclose(f);
+    sort(loops.begin(), loops.end());
+    loops.erase(unique(loops.begin(), loops.end()), loops.end());
+
+    if(loops.empty())
+    {
+        cout << "CloseLoopTester: No ground truth loop to evaluate!" << endl;
+        return;
+    }
+
+    ConfigLoader config("../SonarGaussian/Configs.ini");
+    FrameCandidateIndex index;
+    index.load(config);
+    index.build(sd,jump);
+
+    FILE *fr = fopen((datasetPath + "Results/CandidateRecall.csv").c_str(), "w");
+    if(fr)
+        fprintf(fr,"# K, Candidate pairs, Fraction of pairs, Loops found, Recall\n");
+
+    unsigned long long nPairs = 0;
+    for(unsigned i = 0 ; i < nCols ; i++)
+        if(i + windowGap + 1 < nCols)
+            nPairs+= nCols - i - windowGap - 1;
+
+    unsigned Ks[] = {1, 2, 5, 10, 20, 50, 100, 0};
+    vector<vector<unsigned> > rowCandidates;
+
+    for(unsigned k = 0 ; Ks[k] > 0 ; k++)
+    {
+        index.setK(Ks[k]);
+        index.candidates(windowGap, rowCandidates);
+
+        unsigned long long nCandidates = 0;
+        for(unsigned i = 0 ; i < rowCandidates.size() ; i++)
+            nCandidates+= rowCandidates[i].size();
+
+        unsigned found = 0;
+        for(unsigned l = 0 ; l < loops.size() ; l++)
+            if(FrameCandidateIndex::isCandidate(rowCandidates[loops[l].first], loops[l].second))
+                found++;
+
+        cout << "K = " << Ks[k] << " : " << nCandidates << " of " << nPairs
+             << " pairs (" << (nPairs > 0 ? 100.0*nCandidates/nPairs : 0.0) << "%) , "
+             << found << " of " << loops.size() << " loops , recall "
+             << 100.0*found/loops.size() << "%" << endl;
+
+        if(fr)
+            fprintf(fr,"%u,%llu,%g,%u,%g\n", Ks[k], nCandidates,
+                    nPairs > 0 ? (double) nCandidates/nPairs : 0.0,
+                    found, (double) found/loops.size());
     }
+
+    if(fr)
+        fclose(fr);
 }
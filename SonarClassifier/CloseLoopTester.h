@@ -4,6 +4,7 @@
 #include "WindowTool/Frame.h"
 #include "Sonar/Sonar.h"
 #include "Sonar/SonarDescritor.h"
+#include "Sonar/DescriptorArena.h"
 #include "GraphMatcher/GraphMatcher.h"
 
 #include <vector>
@@ -15,6 +16,7 @@ class CloseLoopTester
 {
     vector<Frame> frames;
     vector<SonarDescritor*> sd;
+    DescriptorArena arena; // Owns sd descriptors, reset on each new batch of frames
     string datasetPath;
     unsigned jump;
 
@@ -29,6 +31,12 @@ public:
 
     void computeMatchs(unsigned windowJump, unsigned start=0, unsigned end=0);
 
+    void computeMatchsOnline();
+
+    void benchmarkVertexMatcher(unsigned windowJump, unsigned nPairs=100);
+
+    void candidateRecall(const char *gtFileName, unsigned windowJump, float minScore=0.f);
+
 };
 
 #endif // CLOSELOOPTESTER_H
@@ -14,14 +14,19 @@ bool GMFBestDirect::findBest(unsigned uId, unsigned &vId)
     if(u1.size() < minEdgeToMatch)
         return false;
 
-    // For each gaussian v
-    for(unsigned v = 0 ; v < gv.size(); v++)
+    signatures.candidates(current_sd1,uId,m_candidates);
+
+    // For each candidate gaussian v
+    for(unsigned k = 0 ; k < m_candidates.size(); k++)
     {
-        if(gv[v].size() < minEdgeToMatch) continue;
+        unsigned v = m_candidates[k];
 
         error = m_vertexMatcher->vertexMatch(current_sd1->gaussians[uId],
                                              current_sd2->gaussians[v],
-                                             u1,gv[v],&edgeMatch);
+                                             u1,gv[v],
+                                             current_sd1->edgesByLength(uId),
+                                             current_sd2->edgesByLength(v),
+                                             &edgeMatch);
 
         if(edgeMatch < minEdgeToMatch) continue;
 
@@ -44,8 +49,8 @@ bool GMFBestDirect::findBest(unsigned uId, unsigned &vId)
 void GMFBestDirect::fastMatchCheck(vector<MatchInfo> &vertexMatch)
 {
     vector<MatchInfo> vertexMatchCopy(vertexMatch);
-    vector<Gaussian> &g1 = current_sd1->gaussians,
-                     &g2 = current_sd2->gaussians;
+    vector<GaussianVertex> &g1 = current_sd1->vertices,
+                           &g2 = current_sd2->vertices;
     unsigned nMatchs = vertexMatch.size();
 
     vertexMatch.clear();
@@ -71,8 +76,8 @@ void GMFBestDirect::fastMatchCheck(vector<MatchInfo> &vertexMatch)
 void GMFBestDirect::fastMatchCheck2(vector<MatchInfo> &vertexMatch)
 {
     vector<MatchInfo> vertexMatchCopy(vertexMatch);
-    vector<Gaussian> &g1 = current_sd1->gaussians,
-                     &g2 = current_sd2->gaussians;
+    vector<GaussianVertex> &g1 = current_sd1->vertices,
+                           &g2 = current_sd2->vertices;
 
     unsigned nMatchs = vertexMatch.size();
 
@@ -81,8 +86,8 @@ void GMFBestDirect::fastMatchCheck2(vector<MatchInfo> &vertexMatch)
     if(nMatchs <= 1)
         return ;
 
-    Gaussian &ref1 = g1[vertexMatchCopy[0].uID],
-             &ref2 = g2[vertexMatchCopy[0].vID];
+    GaussianVertex &ref1 = g1[vertexMatchCopy[0].uID],
+                   &ref2 = g2[vertexMatchCopy[0].vID];
 
     vertexMatch.push_back(vertexMatchCopy[0]);
 
@@ -122,6 +127,8 @@ void GMFBestDirect::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     current_sd1 = sd1;
     current_sd2 = sd2;
 
+    signatures.build(sd2,minEdgeToMatch);
+
     vector<vector<GraphLink *> > &g1 = sd1->graph;
 
     unsigned v;
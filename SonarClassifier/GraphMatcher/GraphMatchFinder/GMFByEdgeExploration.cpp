@@ -15,14 +15,19 @@ bool GMFByEdgeExploration::findBest(unsigned uId, unsigned &vId)
     if(u1.size() < minEdgeToMatch)
         return false;
 
-    // For each gaussian v
-    for(unsigned v = 0 ; v < gv.size(); v++)
+    signatures.candidates(current_sd1,uId,m_candidates);
+
+    // For each candidate gaussian v
+    for(unsigned k = 0 ; k < m_candidates.size(); k++)
     {
-        if(gv[v].size() < minEdgeToMatch) continue;
+        unsigned v = m_candidates[k];
 
         error = m_vertexMatcher->vertexMatch(current_sd1->gaussians[uId],
                                              current_sd2->gaussians[v],
-                                             u1,gv[v],&edgeMatch);
+                                             u1,gv[v],
+                                             current_sd1->edgesByLength(uId),
+                                             current_sd2->edgesByLength(v),
+                                             &edgeMatch);
 
         if(edgeMatch < minEdgeToMatch) continue;
 
@@ -103,8 +108,8 @@ bool GMFByEdgeExploration::explore(unsigned uId, unsigned vId,
 
 bool GMFByEdgeExploration::fastMatchCheck(vector<MatchInfoWeighted> &vertexMatch)
 {
-    vector<Gaussian> &g1 = current_sd1->gaussians,
-                     &g2 = current_sd2->gaussians;
+    vector<GaussianVertex> &g1 = current_sd1->vertices,
+                           &g2 = current_sd2->vertices;
     unsigned nMatchs = vertexMatch.size();
 
     if(nMatchs <= 1)
@@ -133,15 +138,15 @@ bool GMFByEdgeExploration::fastMatchCheck(vector<MatchInfoWeighted> &vertexMatch
 
 bool GMFByEdgeExploration::fastMatchCheck2(vector<MatchInfoWeighted> &vertexMatch)
 {
-    vector<Gaussian> &g1 = current_sd1->gaussians,
-                     &g2 = current_sd2->gaussians;
+    vector<GaussianVertex> &g1 = current_sd1->vertices,
+                           &g2 = current_sd2->vertices;
 
     unsigned nMatchs = vertexMatch.size();
     if(nMatchs <= 1)
         return false;
 
-    Gaussian &ref1 = g1[vertexMatch[0].uID],
-             &ref2 = g2[vertexMatch[0].vID];
+    GaussianVertex &ref1 = g1[vertexMatch[0].uID],
+                   &ref2 = g2[vertexMatch[0].vID];
 
     for(unsigned i = 1; i < nMatchs; i++)
     {
@@ -177,6 +182,8 @@ void GMFByEdgeExploration::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     current_sd1 = sd1;
     current_sd2 = sd2;
 
+    signatures.build(sd2,minEdgeToMatch);
+
     vector<vector<GraphLink *> > &g1 = sd1->graph,
                                  &g2 = sd2->graph;
 
@@ -8,14 +8,21 @@ public:
     Match(unsigned bestMatch, unsigned secBestMatch, unsigned destId):
         bestMatch(bestMatch), secBestMatch(secBestMatch), destId(destId)
     { }
+
+    // There isn't two very similar matchs
+    bool accepted(unsigned minEdgeDiffToAcceptMatch) const
+    {
+        return bestMatch > 0 &&
+               bestMatch - secBestMatch >= minEdgeDiffToAcceptMatch;
+    }
 };
 
 void GMFByVertexMatch::fastMatchCheck(SonarDescritor *sd1, SonarDescritor *sd2,
                                      vector<MatchInfo> &vertexMatch, unsigned basedMatchId,
                                      vector<MatchInfo> &result)
 {
-    vector<Gaussian> &g1 = sd1->gaussians,
-                     &g2 = sd2->gaussians;
+    vector<GaussianVertex> &g1 = sd1->vertices,
+                           &g2 = sd2->vertices;
     unsigned nMatchs = vertexMatch.size();
 
     result.clear();
@@ -59,8 +66,8 @@ void GMFByVertexMatch::fastMatchCheck2(SonarDescritor *sd1, SonarDescritor *sd2,
                                        vector<MatchInfo> &vertexMatch, unsigned basedMatchId,
                                        vector<MatchInfo> &result)
 {
-    vector<Gaussian> &g1 = sd1->gaussians,
-                     &g2 = sd2->gaussians;
+    vector<GaussianVertex> &g1 = sd1->vertices,
+                           &g2 = sd2->vertices;
 
     unsigned nMatchs = vertexMatch.size();
 
@@ -68,8 +75,8 @@ void GMFByVertexMatch::fastMatchCheck2(SonarDescritor *sd1, SonarDescritor *sd2,
     if(nMatchs < 3)
         return ;
 
-    Gaussian &ref1 = g1[vertexMatch[basedMatchId].uID],
-             &ref2 = g2[vertexMatch[basedMatchId].vID];
+    GaussianVertex &ref1 = g1[vertexMatch[basedMatchId].uID],
+                   &ref2 = g2[vertexMatch[basedMatchId].vID];
 
     result.push_back(vertexMatch[basedMatchId]);
 
@@ -137,7 +144,17 @@ bool GMFByVertexMatch::load(ConfigLoader &config)
     return true;
 }
 
-void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vector<MatchInfo> &vertexMatch)
+/**
+ * @brief Match sd1 with sd2.
+ *  Each vertex u changes the match of one vertex v at most, so after
+ * processing some vertex u the final amount of matchs is the amount
+ * of accepted v matchs, plus or minus the amount of vertex u left.
+ * With minMatches > 0 the search stops when it knows the answer.
+ * @param vertexMatch - Matchs found, if not 0x0 (only without minMatches).
+ * @return bool - If there are at least minMatches matchs.
+ */
+bool GMFByVertexMatch::match(SonarDescritor *sd1, SonarDescritor *sd2,
+                             vector<MatchInfo> *vertexMatch, unsigned minMatches)
 {
     vector< vector<GraphLink*> > &g1 = sd1->graph,
                                  &g2 = sd2->graph;
@@ -150,20 +167,41 @@ void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vecto
 
     float error;
 
+    // Bounds of the final amount of matchs
+    unsigned nAccepted = 0, uLeft = 0;
+    for(unsigned u = 0 ; u < g1.size() ; u++)
+        if(g1[u].size() >= minEdgeToMatch) uLeft++;
+
+    if(uLeft < minMatches)
+        return false;
+
+    signatures.build(sd2,minEdgeToMatch);
+
     // For each gaussian u
     for(unsigned u = 0 ; u < g1.size() ; u++)
     {
+        if(minMatches > 0)
+        {
+            if(nAccepted + uLeft < minMatches) return false;
+            if(nAccepted >= minMatches + uLeft) return true;
+        }
+
         if(g1[u].size() < minEdgeToMatch) continue;
+        uLeft--;
 
         bestMatch = secBestMatch = 0;
 
-        // For each gaussian v
-        for(unsigned v = 0 ; v < g2.size(); v++)
+        signatures.candidates(sd1,u,m_candidates);
+
+        // For each candidate gaussian v
+        for(unsigned k = 0 ; k < m_candidates.size(); k++)
         {
-            if(g2[v].size() < minEdgeToMatch) continue;
+            unsigned v = m_candidates[k];
 
             error = m_vertexMatcher->vertexMatch(sd1->gaussians[u],sd2->gaussians[v],
-                                                 g1[u],g2[v],&edgeMatch);
+                                                 g1[u],g2[v],
+                                                 sd1->edgesByLength(u),sd2->edgesByLength(v),
+                                                 &edgeMatch);
 
             if(edgeMatch < minEdgeToMatch) continue;
 
@@ -190,6 +228,7 @@ void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vecto
 
             // Save this match as match from g2 to g1 (inverse match)
             Match &match = matchFromVtoU[matchId];
+            bool wasAccepted = match.accepted(minEdgeDiffToAcceptMatch);
 
             if(bestMatch > match.bestMatch)
             {
@@ -200,20 +239,23 @@ void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vecto
             {
                 match.secBestMatch = bestMatch;
             }
+
+            nAccepted+= match.accepted(minEdgeDiffToAcceptMatch);
+            nAccepted-= wasAccepted;
         }
     }
 
-    for(unsigned v = 0 ; v < g2.size() ; v++)
+    if(vertexMatch != 0x0)
     {
-        Match &match = matchFromVtoU[v];
-
-        // If it was a match from V to U (g2 to g1)
-        if(match.bestMatch > 0)
+        for(unsigned v = 0 ; v < g2.size() ; v++)
         {
-            // If there isn't two very similar matchs
-            if(match.bestMatch - match.secBestMatch >= minEdgeDiffToAcceptMatch)
+            Match &match = matchFromVtoU[v];
+
+            // If it was a match from V to U (g2 to g1)
+            // and there isn't two very similar matchs
+            if(match.accepted(minEdgeDiffToAcceptMatch))
             { // Take this match
-                vertexMatch.push_back(MatchInfo(match.destId, v));
+                vertexMatch->push_back(MatchInfo(match.destId, v));
             }
         }
     }
@@ -229,6 +271,18 @@ void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vecto
 //        }
 //    }
 //    vertexMatch = bestFilterResult;
+
+    return nAccepted >= minMatches;
+}
+
+void GMFByVertexMatch::findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vector<MatchInfo> &vertexMatch)
+{
+    match(sd1,sd2,&vertexMatch,0);
+}
+
+bool GMFByVertexMatch::hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned minMatches)
+{
+    return match(sd1,sd2,0x0,minMatches);
 }
 
 void GMFByVertexMatch::findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2, vector<MatchInfoExtended> &matchInfo)
@@ -16,6 +16,9 @@ private:
     void fastMatchCheck2(SonarDescritor *sd1, SonarDescritor *sd2,
                          vector<MatchInfo> &vertexMatch, unsigned basedMatchId, vector<MatchInfo> &result);
 
+    bool match(SonarDescritor *sd1, SonarDescritor *sd2,
+               vector<MatchInfo> *vertexMatch, unsigned minMatches);
+
 public:
     GMFByVertexMatch();
 
@@ -23,6 +26,7 @@ public:
 public:
     bool load(ConfigLoader &config);
     void findMatch(SonarDescritor *sd1, SonarDescritor *sd2, vector<MatchInfo> &vertexMatch);
+    bool hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned minMatches);
     void findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2, vector<MatchInfoExtended> &matchInfo);
 
 };
@@ -1,6 +1,9 @@
 #include "GMFHungarian.h"
 
-GMFHungarian::GMFHungarian()
+#include <algorithm>
+
+GMFHungarian::GMFHungarian():
+    minMatches(4u)
 {
 }
 
@@ -17,8 +20,15 @@ bool GMFHungarian::load(ConfigLoader &config)
     return gotSomeConfig;
 }
 
-void GMFHungarian::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
-                             vector<MatchInfo> &vertexMatch)
+/**
+ * @brief Fill hu with the vertex pairs that can be assigned.
+ *  The assignment can't have more matchs than the vertex with
+ * some pair on each frame, with requiredMatches > 0 it stops when they
+ * can't reach requiredMatches.
+ * @return bool - false if there can't be requiredMatches matchs.
+ */
+bool GMFHungarian::buildCosts(SonarDescritor *sd1, SonarDescritor *sd2,
+                              unsigned requiredMatches)
 {
     vector< vector<GraphLink*> > &g1 = sd1->graph,
                                  &g2 = sd2->graph;
@@ -28,40 +38,64 @@ void GMFHungarian::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     unsigned int nV1 = g1.size(),
                  nV2 = g2.size();
 
-    map1.setup(nV1);
-    map2.setup(nV2);
-    hu.clear();
+    // Only vertex pairs with minMatches edges matched can be assigned
+    hu.setup(nV1,nV2);
+
+    // Bound of the assignment size, rows with some pair and rows left
+    unsigned nRows = 0, uLeft = 0, nCols = 0;
+    for(unsigned u = 0u ; u < nV1 ; u++)
+        if(g1[u].size() >= minMatches) uLeft++;
+
+    if(uLeft < requiredMatches)
+        return false;
+
+    m_usedCol.assign(nV2,0);
+
+    signatures.build(sd2,minMatches);
 
     // For each gaussian u
     for(unsigned u = 0u ; u < nV1 ; u++)
     {
+        if(nRows + uLeft < requiredMatches)
+            return false;
+
         if(g1[u].size() < minMatches) continue;
+        uLeft--;
 
-        for(unsigned v = 0u ; v < nV2; v++)
+        signatures.candidates(sd1,u,m_candidates);
+
+        bool hasPair = false;
+        for(unsigned k = 0u ; k < m_candidates.size(); k++)
         {
-            if(g2[v].size() < minMatches) continue;
+            unsigned v = m_candidates[k];
 
             edgeMatches = 0u;
             normError = m_vertexMatcher->vertexMatch(sd1->gaussians[u],sd2->gaussians[v],
-                                                 g1[u],g2[v],&edgeMatches);
+                                                 g1[u],g2[v],
+                                                 sd1->edgesByLength(u),sd2->edgesByLength(v),
+                                                 &edgeMatches);
 
             if(edgeMatches >= minMatches)
             {
-                if( map1.count() < hu.maxVertex() && map2.count() < hu.maxVertex())
-                {
-                    hu.cost[map1.map(u)][map2.map(v)] = -(edgeMatches - normError);
-                }else
+                hu.setCost(u,v,-(edgeMatches - normError));
+                hasPair = true;
+                if(!m_usedCol[v])
                 {
-                    cout << "HUngarian:: Vertex limit achived!!" << endl;
+                    m_usedCol[v] = 1;
+                    nCols++;
                 }
             }
         }
+        nRows+= hasPair;
     }
 
-    vector<MatchInfoWeighted> huMatch;
+    return min(nRows,nCols) >= requiredMatches;
+}
 
-    hu.n = nV1;
-    hu.max_match = nV2;
+void GMFHungarian::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
+                             vector<MatchInfo> &vertexMatch)
+{
+    buildCosts(sd1,sd2,0);
 
     hu.hungarian(huMatch);
 
@@ -71,14 +105,26 @@ void GMFHungarian::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     {
         const MatchInfoWeighted &match = huMatch[i];
 
-        vertexMatch[i] =
-           MatchInfo(
-                    map1.inv(match.uID),
-                    map2.inv(match.vID));
+        vertexMatch[i] = MatchInfo(match.uID, match.vID);
     }
 
 }
 
+/**
+ * @brief The minimum cost assignment isn't always the biggest one,
+ * so the search stops only when requiredMatches can't be reached, else
+ * the assignment is solved.
+ */
+bool GMFHungarian::hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned requiredMatches)
+{
+    if(!buildCosts(sd1,sd2,requiredMatches))
+        return false;
+
+    hu.hungarian(huMatch);
+
+    return huMatch.size() >= requiredMatches;
+}
+
 void GMFHungarian::findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                                   vector<MatchInfoExtended> &matchInfo)
 {
@@ -3,16 +3,17 @@
 
 #include "GraphMatchFinder.h"
 #include "Tools/HungarianAlgorithm.h"
-#include "Tools/IndexMapping.h"
 
 class GMFHungarian : public GraphMatchFinder
 {
 private:
     unsigned minMatches;
     HungarianAlgorithm hu;
+    vector<MatchInfoWeighted> huMatch;
+    vector<char> m_usedCol;
 
-    IndexMapping map1, map2;
-
+    bool buildCosts(SonarDescritor *sd1, SonarDescritor *sd2,
+                    unsigned requiredMatches);
 
 public:
     GMFHungarian();
@@ -23,6 +24,8 @@ public:
     void findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
                    vector<MatchInfo> &vertexMatch);
 
+    bool hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned requiredMatches);
+
     void findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                         vector<MatchInfoExtended> &matchInfo);
 };
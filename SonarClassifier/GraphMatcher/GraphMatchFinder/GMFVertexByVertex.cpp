@@ -28,15 +28,32 @@ bool GMFVertexByVertex::load(ConfigLoader &config)
 
 }
 
-void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
-                                  vector<MatchInfo> &vertexMatch)
+/**
+ * @brief The inverse match of a vertex v is taken if its second
+ * best score isn't too close to the best.
+ */
+bool GMFVertexByVertex::meaningful(const PFIF &invScore) const
+{
+    return invScore.first.first < FLT_MAX &&
+           invScore.second - invScore.first.first >= meaningfulness;
+}
+
+/**
+ * @brief Match sd1 with sd2.
+ *  Each vertex u changes the inverse score of one vertex v at most,
+ * so after processing some vertex u the final amount of matchs is the
+ * amount of meaningful inverse scores, plus or minus the amount of
+ * vertex u left. With minMatches > 0 the search stops when it knows
+ * the answer.
+ * @param vertexMatch - Matchs found, if not 0x0 (only without minMatches).
+ * @return bool - If there are at least minMatches matchs.
+ */
+bool GMFVertexByVertex::match(SonarDescritor *sd1, SonarDescritor *sd2,
+                              vector<MatchInfo> *vertexMatch, unsigned minMatches)
 {
     vector< vector<GraphLink*> > &g1 = sd1->graph,
                                  &g2 = sd2->graph;
 
-    typedef pair<float,int> PFI;
-    typedef pair< PFI , float> PFIF;
-
     vector<PFIF> invScore(g2.size(), PFIF(PFI(FLT_MAX,-1) ,FLT_MAX));
     // invScore[ destID ] ( ( bestScore , srcIDBest) , SecondBestScore)
 
@@ -47,21 +64,42 @@ void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     int vertexIDMatch=-1;
     unsigned edgeMatch=0;
 
+    // Bounds of the final amount of matchs
+    unsigned nAccepted = 0, uLeft = 0;
+    for(unsigned u = 0 ; u < g1.size() ; u++)
+        if(g1[u].size() >= minSimilarEdgeToMatch) uLeft++;
+
+    if(uLeft < minMatches)
+        return false;
+
+    signatures.build(sd2,minSimilarEdgeToMatch);
+
     // For each gaussian u
     for(unsigned u = 0 ; u < g1.size() ; u++)
     {
+        if(minMatches > 0)
+        {
+            if(nAccepted + uLeft < minMatches) return false;
+            if(nAccepted >= minMatches + uLeft) return true;
+        }
+
         if(g1[u].size() < minSimilarEdgeToMatch) continue;
+        uLeft--;
 
         bestScore = secondBestScore = FLT_MAX;
         vertexIDMatch=-1;
 
-        // For each gaussian v
-        for(unsigned v = 0 ; v < g2.size(); v++)
+        signatures.candidates(sd1,u,m_candidates);
+
+        // For each candidate gaussian v
+        for(unsigned k = 0 ; k < m_candidates.size(); k++)
         {
-            if(g2[v].size() < minSimilarEdgeToMatch) continue;
+            unsigned v = m_candidates[k];
 
             score = m_vertexMatcher->vertexMatch(sd1->gaussians[u],sd2->gaussians[v],
-                                                 g1[u],g2[v],&edgeMatch);
+                                                 g1[u],g2[v],
+                                                 sd1->edgesByLength(u),sd2->edgesByLength(v),
+                                                 &edgeMatch);
 
             if(edgeMatch < minSimilarEdgeToMatch) continue;
 
@@ -88,6 +126,8 @@ void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
                 continue;
             }
 
+            bool wasAccepted = meaningful(invScore[vertexIDMatch]);
+
             if(invScore[vertexIDMatch].first.first > bestScore)
             {
                 // Now the old best score is second best score
@@ -103,6 +143,9 @@ void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
                 invScore[vertexIDMatch].second = bestScore;
             }
 
+            nAccepted+= meaningful(invScore[vertexIDMatch]);
+            nAccepted-= wasAccepted;
+
 //            vertexMatch.push_back(pair<unsigned , unsigned>(u,vertexIDMatch));
 //            cout << "Match " << u << " com " << vertexIDMatch
 //                 << " score " << bestScore << " second score " << secondBestScore << endl;
@@ -110,19 +153,29 @@ void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     }
 
     // Cuting week matchs
-    for(unsigned i =0  ; i < g2.size() ; i++)
+    for(unsigned i =0  ; i < g2.size() && vertexMatch != 0x0 ; i++)
     {
-        if(invScore[i].first.first < FLT_MAX)
+        if(meaningful(invScore[i]))
         {
-           if(invScore[i].second - invScore[i].first.first < meaningfulness)
-            continue;
-
-            vertexMatch.push_back(MatchInfo(invScore[i].first.second,i));
+            vertexMatch->push_back(MatchInfo(invScore[i].first.second,i));
 
 //            cout << "Match " << invScore[i].first.second << " com " << i
 //                 << " score " << invScore[i].first.first << " second score " << invScore[i].second << endl;
         }
     }
+
+    return nAccepted >= minMatches;
+}
+
+void GMFVertexByVertex::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
+                                  vector<MatchInfo> &vertexMatch)
+{
+    match(sd1,sd2,&vertexMatch,0);
+}
+
+bool GMFVertexByVertex::hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned minMatches)
+{
+    return match(sd1,sd2,0x0,minMatches);
 }
 
 void GMFVertexByVertex::findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
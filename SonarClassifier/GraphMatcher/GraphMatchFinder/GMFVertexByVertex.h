@@ -9,6 +9,14 @@ protected:
     float meaningfulness;
     unsigned minSimilarEdgeToMatch;
 
+    typedef pair<float,int> PFI;
+    typedef pair< PFI , float> PFIF;
+
+    bool meaningful(const PFIF &invScore) const;
+
+    bool match(SonarDescritor *sd1, SonarDescritor *sd2,
+               vector<MatchInfo> *vertexMatch, unsigned minMatches);
+
 public:
     GMFVertexByVertex();
 
@@ -19,6 +27,8 @@ public:
     void findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
                    vector<MatchInfo> &vertexMatch);
 
+    bool hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned minMatches);
+
     void findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                         vector<MatchInfoExtended> &matchInfo);
 };
@@ -9,3 +9,10 @@ void GraphMatchFinder::setVertexMatcher(VertexMatcher *vertexMatcher)
 {
     m_vertexMatcher = vertexMatcher;
 }
+
+bool GraphMatchFinder::hasMatches(SonarDescritor *sd1, SonarDescritor *sd2, unsigned minMatches)
+{
+    m_matchs.clear();
+    findMatch(sd1,sd2,m_matchs);
+    return m_matchs.size() >= minMatches;
+}
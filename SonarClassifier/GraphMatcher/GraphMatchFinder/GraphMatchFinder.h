@@ -7,6 +7,7 @@
 #include "GraphMatcher/VertexMatcher/VertexMatcher.h"
 #include "GraphMatcher/MatchInfo/MatchInfo.h"
 #include "GraphMatcher/MatchInfo/MatchInfo.h"
+#include "GraphMatcher/GraphMatchFinder/VertexSignatureIndex.h"
 
 /**
  * @brief This class compute the error between two graphs,
@@ -18,9 +19,14 @@ class GraphMatchFinder
 {
 protected:
     VertexMatcher *m_vertexMatcher;
+    vector<unsigned> m_candidates; // Vertex candidates buffer
+    vector<MatchInfo> m_matchs;    // hasMatches buffer
 public:
     GraphMatchFinder();
 
+    // Candidate vertex of the second frame, built on each findMatch
+    VertexSignatureIndex signatures;
+
     void setVertexMatcher(VertexMatcher *vertexMatcher);
 
 //Interface
@@ -31,6 +37,15 @@ public:
 
     virtual void findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                             vector<MatchInfoExtended> &matchInfo) =0;
+
+    /**
+     * @brief Answer if findMatch finds at least minMatches
+     * vertex matchs. Finders override it to stop as soon as the
+     * answer is known (minMatches reached or impossible), the
+     * default runs the full findMatch.
+     */
+    virtual bool hasMatches(SonarDescritor *sd1, SonarDescritor *sd2,
+                            unsigned minMatches);
 };
 
 #endif // GRAPHMATCHFINDER_H
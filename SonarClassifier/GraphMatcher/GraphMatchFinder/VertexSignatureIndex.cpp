@@ -0,0 +1,255 @@
+#include "VertexSignatureIndex.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// ====== SignatureMetrics =======
+
+SignatureMetrics::SignatureMetrics():
+    vertexPairs(0), candidates(0)
+{
+}
+
+void SignatureMetrics::clear()
+{
+    vertexPairs = candidates = 0;
+}
+
+void SignatureMetrics::add(const SignatureMetrics &m)
+{
+    vertexPairs+= m.vertexPairs;
+    candidates+= m.candidates;
+}
+
+void SignatureMetrics::print() const
+{
+    unsigned long long pruned = vertexPairs - candidates;
+
+    cout << "Vertex signatures: " << vertexPairs << " vertex pairs, "
+         << candidates << " matched, " << pruned << " pruned ("
+         << (vertexPairs > 0 ? 100.0*pruned/vertexPairs : 0.0)
+         << "%)" << endl;
+}
+
+// ====== VertexSignatureIndex =======
+
+VertexSignatureIndex::VertexSignatureIndex():
+    m_enabled(false),
+    m_lengthBinSize(20.f), m_intensityBinSize(16.f),
+    m_minLengthMatches(0),
+    m_maxDegreeDiff(-1), m_maxIntensityBinDiff(-1), m_maxSizeBinDiff(-1),
+    m_minDegree(0)
+{
+}
+
+bool VertexSignatureIndex::load(ConfigLoader &config)
+{
+    bool gotSomeConfig=false;
+    float fv;
+    int iv;
+
+    if(config.getInt("VertexSignatureIndex","enabled",&iv))
+    {
+        m_enabled = iv != 0;
+        gotSomeConfig=true;
+    }
+
+    if(config.getFloat("VertexSignatureIndex","lengthBinSize",&fv))
+    {
+        if(fv > 0.f) m_lengthBinSize = fv;
+        else cout << "VertexSignatureIndex warning: Invalid lengthBinSize!" << endl;
+        gotSomeConfig=true;
+    }
+
+    if(config.getInt("VertexSignatureIndex","minLengthMatches",&iv))
+    {
+        m_minLengthMatches = max(iv,0);
+        gotSomeConfig=true;
+    }
+
+    if(config.getFloat("VertexSignatureIndex","intensityBinSize",&fv))
+    {
+        if(fv > 0.f) m_intensityBinSize = fv;
+        else cout << "VertexSignatureIndex warning: Invalid intensityBinSize!" << endl;
+        gotSomeConfig=true;
+    }
+
+    if(config.getInt("VertexSignatureIndex","maxDegreeDiff",&iv))
+    {
+        m_maxDegreeDiff = iv;
+        gotSomeConfig=true;
+    }
+
+    if(config.getInt("VertexSignatureIndex","maxIntensityBinDiff",&iv))
+    {
+        m_maxIntensityBinDiff = iv;
+        gotSomeConfig=true;
+    }
+
+    if(config.getInt("VertexSignatureIndex","maxSizeBinDiff",&iv))
+    {
+        m_maxSizeBinDiff = iv;
+        gotSomeConfig=true;
+    }
+
+    return gotSomeConfig;
+}
+
+bool VertexSignatureIndex::enabled() const
+{
+    return m_enabled;
+}
+
+VertexSignature VertexSignatureIndex::signature(const SonarDescritor *sd, unsigned v) const
+{
+    const vector<GraphLink*> &edges = sd->graph[v];
+    const Gaussian &g = sd->gaussians[v];
+
+    VertexSignature s;
+    s.degree = edges.size();
+    s.lengthBins = 0ull;
+    memset(s.lengthCount,0,sizeof(s.lengthCount));
+
+    for(unsigned i = 0 ; i < edges.size(); i++)
+    {
+        unsigned bin = min((unsigned)(edges[i]->p/m_lengthBinSize), VSI_LENGTH_BINS-1u);
+        s.lengthBins |= 1ull << bin;
+        s.lengthCount[bin]++;
+    }
+
+    s.intensityBin = (int) (g.intensity/m_intensityBinSize);
+
+    s.sizeBin = 0;
+    for(unsigned n = g.N ; n > 1u ; n>>=1)
+        s.sizeBin++;
+
+    return s;
+}
+
+/**
+ * @brief Index the vertex of sd with at least minDegree edges.
+ */
+void VertexSignatureIndex::build(const SonarDescritor *sd, unsigned minDegree)
+{
+    unsigned nV = sd->graph.size();
+
+    m_minDegree = minDegree;
+    m_vertex.clear();
+    for(unsigned v = 0 ; v < nV ; v++)
+    {
+        if(sd->graph[v].size() >= minDegree)
+            m_vertex.push_back(v);
+    }
+
+    if(!m_enabled) return;
+
+    m_signatures.resize(nV);
+    m_count.assign(nV,0);
+    m_binBegin.assign(VSI_LENGTH_BINS+1,0);
+
+    for(unsigned k = 0 ; k < m_vertex.size(); k++)
+    {
+        unsigned v = m_vertex[k];
+        m_signatures[v] = signature(sd,v);
+
+        for(unsigned b = 0 ; b < VSI_LENGTH_BINS ; b++)
+        {
+            if(m_signatures[v].lengthBins & (1ull << b))
+                m_binBegin[b+1]++;
+        }
+    }
+
+    for(unsigned b = 1 ; b < m_binBegin.size() ; b++)
+        m_binBegin[b]+= m_binBegin[b-1];
+
+    // Posting lists keep vertex ids ascending
+    vector<unsigned> fill(m_binBegin.begin(), m_binBegin.end()-1);
+    m_binItems.resize(m_binBegin.back());
+    for(unsigned k = 0 ; k < m_vertex.size(); k++)
+    {
+        unsigned v = m_vertex[k];
+        for(unsigned b = 0 ; b < VSI_LENGTH_BINS ; b++)
+        {
+            if(m_signatures[v].lengthBins & (1ull << b))
+                m_binItems[fill[b]++] = v;
+        }
+    }
+}
+
+/**
+ * @brief Vertex of the indexed frame compatible with vertex u
+ * of sd, in ascending id order.
+ */
+void VertexSignatureIndex::candidates(const SonarDescritor *sd, unsigned u,
+                                      vector<unsigned> &ids)
+{
+    metrics.vertexPairs+= m_vertex.size();
+
+    if(!m_enabled)
+    {
+        ids = m_vertex;
+        metrics.candidates+= ids.size();
+        return;
+    }
+
+    VertexSignature su = signature(sd,u);
+
+    // Edges of u that can pair with edges on each bin
+    unsigned near[VSI_LENGTH_BINS];
+    for(unsigned b = 0 ; b < VSI_LENGTH_BINS ; b++)
+    {
+        near[b] = su.lengthCount[b];
+        if(b > 0) near[b]+= su.lengthCount[b-1];
+        if(b+1 < VSI_LENGTH_BINS) near[b]+= su.lengthCount[b+1];
+    }
+
+    vector<unsigned> &touched = m_touched;
+    touched.clear();
+    for(unsigned b = 0 ; b < VSI_LENGTH_BINS ; b++)
+    {
+        if(near[b] == 0) continue;
+
+        for(unsigned k = m_binBegin[b] ; k < m_binBegin[b+1] ; k++)
+        {
+            unsigned v = m_binItems[k];
+            if(m_count[v] == 0)
+                touched.push_back(v);
+            m_count[v]+= min(near[b], m_signatures[v].lengthCount[b]);
+        }
+    }
+
+    unsigned minMatches = m_minLengthMatches > 0 ? m_minLengthMatches : m_minDegree;
+
+    // Without minimum of matches all vertex are tested
+    const vector<unsigned> &tested = minMatches > 0 ? touched : m_vertex;
+
+    ids.clear();
+    for(unsigned k = 0 ; k < tested.size(); k++)
+    {
+        unsigned v = tested[k];
+        const VertexSignature &sv = m_signatures[v];
+
+        if(m_count[v] < minMatches) continue;
+
+        if(m_maxDegreeDiff >= 0 &&
+           abs((int) su.degree - (int) sv.degree) > m_maxDegreeDiff) continue;
+
+        if(m_maxIntensityBinDiff >= 0 &&
+           abs(su.intensityBin - sv.intensityBin) > m_maxIntensityBinDiff) continue;
+
+        if(m_maxSizeBinDiff >= 0 &&
+           abs(su.sizeBin - sv.sizeBin) > m_maxSizeBinDiff) continue;
+
+        ids.push_back(v);
+    }
+
+    for(unsigned k = 0 ; k < touched.size(); k++)
+        m_count[touched[k]] = 0;
+
+    // Same order of a scan over all vertex
+    sort(ids.begin(), ids.end());
+
+    metrics.candidates+= ids.size();
+}
@@ -0,0 +1,99 @@
+#ifndef VERTEXSIGNATUREINDEX_H
+#define VERTEXSIGNATUREINDEX_H
+
+#include <vector>
+
+#include "Sonar/SonarDescritor.h"
+#include "Sonar/SonarConfig/ConfigLoader.h"
+
+using namespace std;
+
+// Length bins of a signature, longer edges go to the last bin
+#define VSI_LENGTH_BINS 64u
+
+/**
+ * @brief Cheap fingerprint of a graph vertex, used to discard
+ * vertex pairs before the VertexMatcher.
+ */
+class VertexSignature
+{
+public:
+    unsigned degree;
+    unsigned long long lengthBins; // Bit b is set if lengthCount[b] > 0
+    unsigned lengthCount[VSI_LENGTH_BINS]; // Edge length histogram
+    int intensityBin,
+        sizeBin; // log2 of pixels amount
+};
+
+/**
+ * @brief Counters of vertex pairs tested and kept by
+ * a VertexSignatureIndex.
+ */
+class SignatureMetrics
+{
+public:
+    SignatureMetrics();
+
+    unsigned long long vertexPairs, // Pairs that would be matched without pruning
+                       candidates;  // Pairs sent to the vertex matcher
+
+    void clear();
+    void add(const SignatureMetrics &m);
+    void print() const;
+};
+
+/**
+ * @brief Inverted index of vertex signatures of one frame.
+ *
+ *  Edge lengths are quantised on bins of lengthBinSize, each
+ * bin keeps the list of vertex with some edge on it (posting
+ * lists, stored as CSR). A query of vertex u visits the lists
+ * of u bins and its neighbor bins and bounds, for each vertex v,
+ * how many edges of v can be paired with an edge of u with length
+ * difference lower than lengthBinSize:
+ *    sum_b min( v[b] , u[b-1] + u[b] + u[b+1] )
+ *  Vertex with bound lower than minLengthMatches or with too
+ * different degree, intensity or size are discarded.
+ *
+ *  With lengthBinSize >= VMHeuristicByAngVariation errorThreshold
+ * and distThreshold, minLengthMatches = 0 (the finder minimum
+ * degree) and the max*Diff tolerances off, no vertex pair that
+ * could reach the finder minimum matches is lost. Higher
+ * minLengthMatches and the tolerances trade recall for speed.
+ * When disabled (default) the candidates are all vertex with
+ * the minimum degree, same pairs of the finders without index.
+ */
+class VertexSignatureIndex
+{
+    bool m_enabled;
+    float m_lengthBinSize, m_intensityBinSize;
+    unsigned m_minLengthMatches; // 0 uses the minimum degree
+    int m_maxDegreeDiff, m_maxIntensityBinDiff, m_maxSizeBinDiff; // -1 ignores the attribute
+
+    unsigned m_minDegree;
+
+    vector<VertexSignature> m_signatures;
+    vector<unsigned> m_vertex,    // Vertex with minimum degree, ascending ids
+                     m_binBegin,  // Bin b vertex are m_binItems[m_binBegin[b] , m_binBegin[b+1])
+                     m_binItems,
+                     m_count,     // Query length matches bounds
+                     m_touched;   // Vertex with m_count > 0 on the query
+
+public:
+    VertexSignatureIndex();
+
+    SignatureMetrics metrics;
+
+    bool load(ConfigLoader &config);
+
+    bool enabled() const;
+
+    VertexSignature signature(const SonarDescritor *sd, unsigned v) const;
+
+    void build(const SonarDescritor *sd, unsigned minDegree);
+
+    void candidates(const SonarDescritor *sd, unsigned u,
+                    vector<unsigned> &ids);
+};
+
+#endif // VERTEXSIGNATUREINDEX_H
@@ -217,6 +217,7 @@ void GraphMatcher::load(ConfigLoader &config)
     if(gmf != 0x0)
     {
         gmf->load(config);
+        gmf->signatures.load(config);
         setGraphFinder(gmf);
     }else
     {
@@ -231,6 +232,16 @@ void GraphMatcher::findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
     m_gmf->findMatch(sd1,sd2,vertexMatch);
 }
 
+/**
+ * @brief Answer if findMatch finds at least minMatches vertex
+ * matchs, stopping as soon as it is known (see GraphMatchFinder::hasMatches).
+ */
+bool GraphMatcher::hasMatches(SonarDescritor *sd1, SonarDescritor *sd2,
+                              unsigned minMatches)
+{
+    return m_gmf->hasMatches(sd1,sd2,minMatches);
+}
+
 void GraphMatcher::findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                                   vector<MatchInfoExtended> &matchInfo)
 {
@@ -92,6 +92,9 @@ public:
     void findMatch(SonarDescritor *sd1, SonarDescritor *sd2,
                    vector<MatchInfo> &vertexMatch);
 
+    bool hasMatches(SonarDescritor *sd1, SonarDescritor *sd2,
+                    unsigned minMatches);
+
     void findMatchDebug(SonarDescritor *sd1, SonarDescritor *sd2,
                         vector<MatchInfoExtended> &matchInfo);
 
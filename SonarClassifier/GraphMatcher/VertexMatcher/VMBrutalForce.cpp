@@ -1,174 +1,285 @@
 #include "VMBrutalForce.h"
+#include "GraphMatcher/GraphMatcher.h"
 
-#include <stack>
+#include <cfloat>
+#include <algorithm>
 using namespace std;
 
-VMBrutalForce::VMBrutalForce()
+// Float rounding margin of the length bounds (scalene error >= length difference)
+#define VMBF_LENGTH_MARGIN 1.f
+#define VMBF_BOUND_FACTOR 0.999f
+
+VMBrutalForce::VMBrutalForce():
+    distThreshold(15.f), errorThreshold(20.f), maxDegree(64),
+    m_stamp(0), m_degreeWarning(false),
+    m_bestCount(0), m_bestError(FLT_MAX)
 {
+    allocWorkspace();
 }
 
-void VMBrutalForce::brutalFORCExplore(vector<GraphLink *> &u, vector<vector<vector<PFPUU> > > &explore)
+/**
+ * @brief Allocate the search buffers to vertex with
+ * up to maxDegree edges, nothing is allocated while matching.
+ */
+void VMBrutalForce::allocWorkspace()
 {
-    //    vector< // Group Size
-    //            vector< // Group
-    //                vector<PFPUU> // Elements (Diff Ang, initial Edge ID, end Edge ID)
-    //                  >
-    //          > explore;
-
-        explore.resize(u.size()+1,vector< vector<PFPUU> >());
-
-
-        explore[u.size()].push_back( vector<PFPUU> ());
-        for(unsigned i = 0; i < u.size()-1; i++)
-        {
-            explore[u.size()][0].push_back(PFPUU(u[i]->invAngle,PUU(i,i+1)));
-        }
-        explore[u.size()][0].push_back(PFPUU(u[u.size()-1]->invAngle,PUU(u.size()-1,0)));
+    m_stack.resize(maxDegree);
+    m_bestU.resize(maxDegree);
+    m_bestV.resize(maxDegree);
+    m_bestPairError.resize(maxDegree);
+    m_domCount.assign(maxDegree*maxDegree,0);
+    m_domStamp.assign(maxDegree*maxDegree,0);
+    m_domError.assign(maxDegree*maxDegree,0.f);
+    m_edgeBound.resize(maxDegree);
+    m_lengthBound.resize(maxDegree+1);
+    m_stamp = 0;
+}
 
-        stack<
-             pair<unsigned,// setSize
-                pair<unsigned, // setID
-                     unsigned  // postion of last swap
-                    >
-                 >
-             > q; // Recursive Stack!
+bool VMBrutalForce::load(ConfigLoader &config)
+{
+    bool gotSomeConfig=false;
+    float fv;
+    int iv;
+
+    if(config.getFloat("VMBrutalForce","distThreshold",&fv))
+    {
+        distThreshold= fv;
+        gotSomeConfig=true;
+    }
+
+    if(config.getFloat("VMBrutalForce","errorThreshold",&fv))
+    {
+        errorThreshold= fv;
+        gotSomeConfig=true;
+    }
+
+    if(config.getInt("VMBrutalForce","maxDegree",&iv))
+    {
+        if(iv > 1) maxDegree = iv;
+        else cout << "VMBrutalForce warning: Invalid maxDegree!" << endl;
+        gotSomeConfig=true;
+    }
+
+    allocWorkspace();
+
+    return gotSomeConfig;
+}
 
-        q.push(PUPUU(u.size(),PUU(0,0)));
-        unsigned setSize,nextSize, setID,lastSwapPostion;
+float VMBrutalForce::computeEdgeAngDiff(GraphLink *uBegin, GraphLink *uEnd)
+{
+    if(uBegin->ang <= uEnd->ang)
+    {
+        return uEnd->ang - uBegin->ang;
+    }else
+    {
+        return 360.f - uBegin->ang + uEnd->ang;
+    }
+}
 
-        while(!q.empty())
+/**
+ * @brief Search the best solution that starts on reference
+ * edges (uRef , vRef), updating the best solution found.
+ *  Pairs are offsets (a , b) from the reference edges in
+ * clockwise order, so the edges are u[(uRef+a)%nU] and
+ * v[(vRef+b)%nV] and both offsets increase along a solution.
+ */
+void VMBrutalForce::search(vector<GraphLink *> &u, vector<GraphLink *> &v,
+                           unsigned uRef, unsigned vRef)
+{
+    unsigned nU = u.size(), nV = v.size();
+
+    // New dominance table
+    m_stamp++;
+    if(m_stamp == 0)
+    {
+        m_domStamp.assign(m_domStamp.size(),0);
+        m_stamp = 1;
+    }
+
+    // Lower bound of the error of a pair with u edges
+    // of offset a or more
+    m_lengthBound[nU] = 0.f;
+    m_lengthBound[nU-1] = m_edgeBound[(uRef+nU-1)%nU];
+    for(int a = nU-2 ; a >= 0 ; a--)
+        m_lengthBound[a] = min(m_lengthBound[a+1], m_edgeBound[(uRef+a)%nU]);
+
+    Frame *stack = &m_stack[0];
+    unsigned top = 0;
+
+    stack[0].a = stack[0].b = 0;
+    stack[0].nextA = stack[0].nextB = 1;
+    stack[0].error = fabs(u[uRef]->p - v[vRef]->p);
+
+    while(true)
+    {
+        Frame &f = stack[top];
+        unsigned count = top+1, // Pairs of f solution
+                 a, b;
+        float error=0.f;
+        bool found = false;
+
+        GraphLink *uBegin = u[(uRef+f.a)%nU],
+                  *vBegin = v[(vRef+f.b)%nV];
+
+        // Next child of f
+        while(!found && f.nextA < nU)
         {
-            setSize = q.top().first;
-            setID = q.top().second.first;
-            lastSwapPostion = q.top().second.second;
-            q.pop();
-
-            nextSize = setSize-1;
-
-            // Get current config
-            vector<PFPUU> &exp = explore[setSize][setID];
-            unsigned iSwap, jSwap;
-
-            // Perform recursive swaps in corrent config set
-            // Changes aways start at beginner (iSwap=0)
-            for(lastSwapPostion, iSwap =0; lastSwapPostion < setSize; lastSwapPostion++, iSwap++)
+            if(f.nextB >= nV)
             {
-                // Create a new set configuration
-                unsigned newSetID = explore[nextSize].size();
-
-                explore[nextSize].push_back( vector<PFPUU> ());
-                vector<PFPUU> &newExp = explore[nextSize][newSetID];
-
-                newExp.reserve(nextSize);
-
-                jSwap = (iSwap+1)%setSize;
-                // Blend two elements (iSwap with jSwap)
-               newExp.push_back(PFPUU(
-                                     exp[iSwap].first + exp[jSwap].first,
-                                     PUU(exp[iSwap].second.first, exp[jSwap].second.second)
-                                      )
-                                 );
-
-                unsigned i = (iSwap+2)%setSize,
-                         m = setSize-3;
-
-                // Copy remainded elements
-                while(m < 999999)
-                {
-                    newExp.push_back(exp[i]);
-                    i=(i+1)%setSize; // Circular increment
-                    m--;
-                }
-
-                // Work with new set created
-                if(nextSize>2 && lastSwapPostion < nextSize)
-                {
-                    q.push(PUPUU(nextSize,PUU(newSetID,lastSwapPostion)));
-                }
+                f.nextA++;
+                f.nextB = f.b+1;
+                continue;
             }
-        }
 
-    #ifdef DEBUG_GRAPHMACHER
-        for(unsigned setSize = u.size(); setSize > 1;setSize--)
-        {
-            for(unsigned setID = 0 ; setID < explore[setSize].size(); setID++)
+            a = f.nextA;
+            b = f.nextB++;
+
+            // Most pairs reachable with the child, it only
+            // decreases with b
+            unsigned bound = count + 1 + min(nU-1-a, nV-1-b);
+            if(bound < m_bestCount)
             {
-                for(unsigned k = 0 ; k < explore[setSize][setID].size() ; k++)
-                {
-                    cout << "(" << explore[setSize][setID][k].first
-                         << " , " << explore[setSize][setID][k].second.first
-                         << " , " << explore[setSize][setID][k].second.second
-                         << " ) ";
-                }
-                cout << endl;
+                f.nextB = nV;
+                continue;
             }
-        }
-    #endif
-}
-
-void VMBrutalForce::brutalFORCEEdgeConfigCompare(vector<GraphLink *> &u, vector<PFPUU> &uExp, vector<GraphLink *> &v, vector<PFPUU> &vExp)
-{
-    //    if(uExp.size() > 0 && uExp.size() != vExp.size())
-    //        return;
 
-    //    unsigned nEdges = uExp.size(),
-    //             nComb = nEdges-1;
+            GraphLink *uEnd = u[(uRef+a)%nU],
+                      *vEnd = v[(vRef+b)%nV];
 
-    //    float bestScore=999999.f,
-    //          angDiff, distDiff;
+            // Scalene error is never lower than the length difference
+            if(fabs(uEnd->p - vEnd->p) >= errorThreshold + VMBF_LENGTH_MARGIN)
+                continue;
 
-    //    int bestComb = -1;
+            float angDiff = fabs(computeEdgeAngDiff(uBegin,uEnd) - computeEdgeAngDiff(vBegin,vEnd)),
+                  pairError = GraphMatcher::scaleneError(angDiff,uEnd->p,vEnd->p);
 
-    //    for(unsigned comb = 0 ; comb < nComb; comb++)
-    //    {
-    //        float angMeanDiff = 0.f,
-    //              distMeanDiff = 0.f;
+            if(pairError >= errorThreshold)
+                continue;
 
-    //        unsigned i = 0;
-    //        while(i < nEdges)
-    //        {
-    //            angDiff = fabs(uExp[i].first - vExp[(i+comb)%nEdges].first);
-    //            if(angDiff > angThreshold)
-    //                break;
+            error = f.error + pairError;
 
-    //            distDiff = fabs(uExp[i].second.first - vExp[(i+comb)%nEdges].second.first);
-    //            if(distDiff > distThreshold)
-    //                break;
-    //            // The second edge will be tested ont the next iteration
+            // Can't beat the best error with the same amount of pairs
+            if(bound == m_bestCount &&
+               error + (bound-count-1)*m_lengthBound[a+1]*VMBF_BOUND_FACTOR > m_bestError)
+                continue;
 
-    //            angMeanDiff += angDiff;
-    //            distMeanDiff += distDiff;
+            // Dominated by a solution that ended on the same pair
+            unsigned d = a*maxDegree + b;
+            if(m_domStamp[d] == m_stamp &&
+               m_domCount[d] >= count+1 && m_domError[d] <= error)
+                continue;
 
-    //            i++;
-    //        }
+            m_domStamp[d] = m_stamp;
+            m_domCount[d] = count+1;
+            m_domError[d] = error;
 
-    //        if(i < nEdges)
-    //            continue;
+            found = true;
+        }
 
-    //        // OK, we find a match
-    //        // now, we will evaluate this match
+        if(!found)
+        {
+            if(top == 0) break;
+            top--;
+            continue;
+        }
 
-    //        angMeanDiff /= nEdges;
-    //        distMeanDiff /= nEdges;
+        top++;
+        Frame &child = stack[top];
+        child.a = a;
+        child.b = b;
+        child.nextA = a+1;
+        child.nextB = b+1;
+        child.error = error;
+
+        // More pairs first, after less error
+        if(top+1 > m_bestCount ||
+          (top+1 == m_bestCount && error < m_bestError))
+        {
+            m_bestCount = top+1;
+            m_bestError = error;
 
-    //        if(angMeanDiff)
-    //    }
+            for(unsigned k = 0 ; k <= top ; k++)
+            {
+                m_bestU[k] = (uRef+stack[k].a)%nU;
+                m_bestV[k] = (vRef+stack[k].b)%nV;
+                m_bestPairError[k] = k == 0 ? stack[0].error :
+                                              stack[k].error - stack[k-1].error;
+            }
+        }
+    }
 }
 
-bool VMBrutalForce::load(ConfigLoader &config)
+/**
+ * @brief Best solution over all reference edges with
+ * length difference lower than distThreshold.
+ * @return float - Mean error of best solution over errorThreshold,
+ * 1.f if no solution was found.
+ */
+float VMBrutalForce::solve(vector<GraphLink *> &u, vector<GraphLink *> &v)
 {
+    m_bestCount = 0;
+    m_bestError = FLT_MAX;
+
+    // This method need more than one edge to match
+    if(u.size() <= 1 || v.size() <= 1)
+        return 1.f;
+
+    if(u.size() > maxDegree || v.size() > maxDegree)
+    {
+        if(!m_degreeWarning)
+        {
+            cout << "VMBrutalForce warning: Vertex with more than "
+                 << maxDegree << " edges are not matched, increase maxDegree!" << endl;
+            m_degreeWarning = true;
+        }
+        return 1.f;
+    }
+
+    for(unsigned i = 0 ; i < u.size() ; i++)
+    {
+        m_edgeBound[i] = FLT_MAX;
+        for(unsigned j = 0 ; j < v.size() ; j++)
+            m_edgeBound[i] = min(m_edgeBound[i], (float) fabs(u[i]->p - v[j]->p));
+    }
+
+    for(unsigned i = 0 ; i < u.size() ; i++)
+    {
+        for(unsigned j = 0 ; j < v.size() ; j++)
+        {
+            if(fabs(u[i]->p - v[j]->p) < distThreshold)
+                search(u,v,i,j);
+        }
+    }
+
+    // A solution need more than the reference edges
+    if(m_bestCount < 2)
+    {
+        m_bestCount = 0;
+        return 1.f;
+    }
 
-    return false;
+    return (m_bestError/m_bestCount)/errorThreshold;
 }
 
 float VMBrutalForce::vertexMatch(Gaussian &gu, Gaussian &gv, vector<GraphLink *> &eu, vector<GraphLink *> &ev, unsigned *matchEdges)
 {
+    float score = solve(eu,ev);
 
+    if(matchEdges != 0x0)
+        *matchEdges = m_bestCount;
+
+    return score;
 }
 
 float VMBrutalForce::vertexMatch(Gaussian &gu, Gaussian &gv,
                                  vector<GraphLink *> &u, vector<GraphLink *> &v,
                                  vector<MatchInfoWeighted> &matchEdges)
 {
+    float score = solve(u,v);
+
+    matchEdges.clear();
+    for(unsigned k = 0 ; k < m_bestCount ; k++)
+        matchEdges.push_back(MatchInfoWeighted(m_bestU[k],m_bestV[k],m_bestPairError[k]));
 
+    return score;
 }
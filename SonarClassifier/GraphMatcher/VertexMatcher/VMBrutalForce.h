@@ -6,30 +6,68 @@
 
 /**
  * @brief This method compute the vertex affinity
- * witout use shape characteristic of features. This
- * is a brutal force aproach that have to find the best
- * soluction but its computacional complexti is exponencial
- * and impratical to be used.
+ * witout use shape characteristic of features. It
+ * finds the best edge match (the exact solution of
+ * VMHeuristicByAngVariation), to be used as baseline.
  *
- * This class implementation was not finished yet.
+ *  A solution is a reference edge pair with length difference
+ * lower than distThreshold, followed by edge pairs in the same
+ * clockwise order on both vertex. Each pair is compared with the
+ * previous one by the scalene error of the angle between them
+ * and must be lower than errorThreshold. The best solution has
+ * more pairs and after less error.
  *
+ *  The search is a depth first branch and bound:
+ *  - Partial solutions that can't reach the best amount of
+ * pairs, or its error with an admissible lower bound of the
+ * remaining error (length difference of the edges) can't beat
+ * the best, are pruned.
+ *  - The continuation of a partial solution depends only on its
+ * last pair, partial solutions dominated by a previous one ending
+ * on the same pair are pruned.
+ *  All buffers are allocated to maxDegree edges, vertex with
+ * more edges aren't matched.
  */
 class VMBrutalForce : public VertexMatcher
 {
-public:
-    typedef pair<unsigned,unsigned> PUU;
-    typedef pair<float, PUU> PFPUU;
-    typedef pair<unsigned, PUU> PUPUU;
+private:
+    float distThreshold,
+          errorThreshold;
+    unsigned maxDegree;
 
-    VMBrutalForce();
+    // Search workspace, sized by maxDegree
+    class Frame
+    {
+    public:
+        unsigned a, b,         // Last pair (offsets from the reference pair)
+                 nextA, nextB; // Next child pair to test
+        float error;           // Error accumulated
+    };
+
+    vector<Frame> m_stack;
+    vector<unsigned> m_bestU, m_bestV; // Best solution edges
+    vector<float> m_bestPairError;
+    vector<unsigned> m_domCount, m_domStamp; // Dominance, by last pair (a*maxDegree+b)
+    vector<float> m_domError;
+    vector<float> m_edgeBound,   // m_edgeBound[i] lower bound of a pair error with edge i of u
+                  m_lengthBound; // m_lengthBound[a] lower bound with u edges from offset a
+    unsigned m_stamp;
+    bool m_degreeWarning;
+
+    unsigned m_bestCount;
+    float m_bestError;
 
+    void allocWorkspace();
 
-    void brutalFORCExplore(vector<GraphLink *> &u,
-                           vector< vector< vector<PFPUU> > > &explore);
+    void search(vector<GraphLink *> &u, vector<GraphLink *> &v,
+                unsigned uRef, unsigned vRef);
 
-    void brutalFORCEEdgeConfigCompare(vector<GraphLink *> &u, vector<PFPUU> &uExp,
-                                      vector<GraphLink *> &v, vector<PFPUU> &vExp
-                                     );
+    float computeEdgeAngDiff(GraphLink *uBegin, GraphLink *uEnd);
+
+    float solve(vector<GraphLink *> &u, vector<GraphLink *> &v);
+
+public:
+    VMBrutalForce();
 
     // VertexMatcher interface
 public:
@@ -3,6 +3,10 @@
 #include "Drawing/Drawing.h"
 
 #include <queue>
+#include <algorithm>
+
+// Float rounding margin of the length bounds used with edge signatures
+#define VMHAV_LENGTH_MARGIN 1.f
 
 VMHeuristicByAngVariation::VMHeuristicByAngVariation()
 {
@@ -83,6 +87,82 @@ float VMHeuristicByAngVariation::vertexMatch(Gaussian &gu, Gaussian &gv,
     return bestSolutionError/errorThreshold;
 }
 
+/**
+ * @brief Same result of vertexMatch above, reference edges
+ * with compatible length are found by a merge join of the edge
+ * signatures (edges sorted by length) instead of testing all
+ * pairs of edges.
+ *
+ * @param euByLength - Ids of eu sorted by length (GraphEdges::byLength)
+ * @param evByLength - Ids of ev sorted by length
+ */
+float VMHeuristicByAngVariation::vertexMatch(Gaussian &gu, Gaussian &gv,
+                                           vector<GraphLink *> &eu, vector<GraphLink *> &ev,
+                                           const unsigned *euByLength, const unsigned *evByLength,
+                                           unsigned *matchEdges)
+{
+    if(euByLength == 0x0 || evByLength == 0x0)
+        return vertexMatch(gu,gv,eu,ev,matchEdges);
+
+    unsigned bestMatch=0;
+
+    // This method need more than one edge to match
+    if(eu.size() <= 1 || ev.size() <= 1)
+        return 1.f;
+
+    // Reference edge guesses, the window over ev lengths is a bit
+    // bigger than distThreshold and the exact test is the same of
+    // the all pairs scan
+    vector<PUU> guess;
+    unsigned vBegin = 0;
+    for(unsigned a = 0 ; a < eu.size() ; a++)
+    {
+        unsigned i = euByLength[a];
+        float p = eu[i]->p;
+
+        while(vBegin < ev.size() &&
+              ev[evByLength[vBegin]]->p < p - distThreshold - VMHAV_LENGTH_MARGIN)
+            vBegin++;
+
+        for(unsigned b = vBegin ; b < ev.size() &&
+            ev[evByLength[b]]->p <= p + distThreshold + VMHAV_LENGTH_MARGIN ; b++)
+        {
+            unsigned j = evByLength[b];
+            if(fabs(p - ev[j]->p) < distThreshold)
+                guess.push_back(PUU(i,j));
+        }
+    }
+
+    // Guesses are tested in the all pairs scan order,
+    // it decides between solutions with same size and error
+    sort(guess.begin(), guess.end());
+
+    vector<MatchInfoWeighted> match;
+
+    float bestSolutionError = errorThreshold;
+
+    for(unsigned k = 0 ; k < guess.size() ; k++)
+    {
+        float soluctionError= findCompativelEdges(guess[k].first,guess[k].second,
+                                                  eu,ev,match,true);
+
+        if(match.size() > bestMatch)
+        {
+            bestMatch = match.size();
+            bestSolutionError = soluctionError;
+        }else if(match.size() == bestMatch && bestSolutionError < soluctionError)
+        {
+            bestMatch = match.size();
+            bestSolutionError = soluctionError;
+        }
+    }
+
+    if(matchEdges != 0x0)
+        *matchEdges = bestMatch;
+
+    return bestSolutionError/errorThreshold;
+}
+
 float VMHeuristicByAngVariation::vertexMatch_orig(Gaussian &gu, Gaussian &gv, vector<GraphLink *> &eu, vector<GraphLink *> &ev, unsigned *matchEdges)
 {
     vector<vector<PUU> > match(1);
@@ -349,11 +429,15 @@ float VMHeuristicByAngVariation::findCompativelEdgesByLenght(unsigned sourceEdge
  * @param v - Vertex v
  * @param match - Matchs found ( ( u edge ID, v edge ID ) ,
  * (scalene error , 0.f) )
+ * @param lengthBound - Reject end edges by its length difference
+ * (a lower bound of the scalene error) before computing the error,
+ * the matchs found are the same.
  * @return float - Mean error of match.
  */
 float VMHeuristicByAngVariation::findCompativelEdges(unsigned uBeginEdgeId, unsigned vBeginEdgeId,
                                                      vector<GraphLink *> &u, vector<GraphLink *> &v,
-                                                     vector<MatchInfoWeighted> &match)
+                                                     vector<MatchInfoWeighted> &match,
+                                                     bool lengthBound)
 {
     match.clear();
 
@@ -379,7 +463,12 @@ float VMHeuristicByAngVariation::findCompativelEdges(unsigned uBeginEdgeId, unsi
         float uAngDiff = computeEdgeAngDiff(u[uBeginEdgeId],u[uEndEdgeId]),
               vAngDiff = computeEdgeAngDiff(v[vBeginEdgeId],v[vEndEdgeId]),
               angDiff = std::fabs(uAngDiff-vAngDiff),
-              error =  GraphMatcher::scaleneError(angDiff,u[uEndEdgeId]->p,v[vEndEdgeId]->p);
+              error = errorThreshold;
+
+        // Scalene error is never lower than the length difference
+        if(!lengthBound ||
+           std::fabs(u[uEndEdgeId]->p - v[vEndEdgeId]->p) < errorThreshold + VMHAV_LENGTH_MARGIN)
+            error = GraphMatcher::scaleneError(angDiff,u[uEndEdgeId]->p,v[vEndEdgeId]->p);
 
         if(error < errorThreshold)
         {
@@ -34,6 +34,11 @@ public:
                       vector<GraphLink *> &eu, vector<GraphLink *> &ev,
                       unsigned *matchEdges);
 
+    float vertexMatch(Gaussian &gu, Gaussian &gv,
+                      vector<GraphLink *> &eu, vector<GraphLink *> &ev,
+                      const unsigned *euByLength, const unsigned *evByLength,
+                      unsigned *matchEdges);
+
     float vertexMatch_orig(Gaussian &gu, Gaussian &gv,
                       vector<GraphLink *> &eu, vector<GraphLink *> &ev,
                       unsigned *matchEdges);
@@ -54,7 +59,8 @@ private:
 
     float findCompativelEdges(unsigned uBeginEdgeId, unsigned vBeginEdgeId,
                                      vector<GraphLink *> &u, vector<GraphLink *> &v,
-                                     vector<MatchInfoWeighted> &match);
+                                     vector<MatchInfoWeighted> &match,
+                                     bool lengthBound=false);
 
     float computeError();
 
@@ -12,4 +12,13 @@ VertexMatcher::~VertexMatcher()
 
 }
 
-
+/**
+ * @brief Default implementation, the edge signatures are ignored.
+ */
+float VertexMatcher::vertexMatch(Gaussian &gu, Gaussian &gv,
+                                 vector<GraphLink *> &eu, vector<GraphLink *> &ev,
+                                 const unsigned *euByLength, const unsigned *evByLength,
+                                 unsigned *matchEdges)
+{
+    return vertexMatch(gu,gv,eu,ev,matchEdges);
+}
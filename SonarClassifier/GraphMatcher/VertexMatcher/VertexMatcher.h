@@ -42,6 +42,20 @@ public:
                               vector<GraphLink *> &eu, vector<GraphLink *> &ev,
                               unsigned *matchEdges=0x0) = 0;
 
+    /**
+     * @brief Compute the similarity between vertex, with their
+     * edge signatures (GraphEdges::byLength). Matchers that pair
+     * edges by length use them to avoid testing all pairs, the
+     * result is the same of the method above.
+     *
+     * @param euByLength - Ids of eu sorted by length or 0x0
+     * @param evByLength - Ids of ev sorted by length or 0x0
+     */
+    virtual float vertexMatch(Gaussian &gu, Gaussian &gv,
+                              vector<GraphLink *> &eu, vector<GraphLink *> &ev,
+                              const unsigned *euByLength, const unsigned *evByLength,
+                              unsigned *matchEdges=0x0);
+
 
     /**
      * @brief It is a debug mode of similarity computation,
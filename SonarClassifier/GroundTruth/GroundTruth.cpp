@@ -1404,7 +1404,7 @@ void GroundTruth::createGaussian(Segment *seg, Gaussian *g)
         cout << "GroundTruth:createGaussian:: use!" << endl;
     #endif
 
-    Mat sample = seg->result(Rect(0,0,seg->N,3)),
+    Mat sample = seg->pixels(),
         mCov, mMean, eVal, eVect;
 
     // Calculate Covariance Matrix of the sample found
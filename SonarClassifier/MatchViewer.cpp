@@ -719,6 +719,9 @@ void MatchViewer::closeLoopDetection(const string &datasetPath, unsigned start,u
 //    clt.loadFrames("Frames_shortDataset.txt");
     clt.loadFrames("Frames.txt");
     clt.describeFrames();
+//    clt.benchmarkVertexMatcher(1);
+//    clt.candidateRecall("GTMatchs.csv",0);
+//    clt.computeMatchsOnline();
     clt.computeMatchs(0,start,end);
 }
 
@@ -0,0 +1,136 @@
+#ifndef FLOODFILL_H
+#define FLOODFILL_H
+
+#include "Segmentation.h"
+#include "Segment.h"
+#include "FloodFillQueue.h"
+
+/**
+ * @brief Where FloodFillPolicy::visit() sends a neighbor pixel.
+ */
+enum FloodFillPush
+{
+    FLOOD_FILL_SKIP = -1,
+    FLOOD_FILL_PRIMARY = 0,   /**< Queue expanded first */
+    FLOOD_FILL_SECONDARY = 1  /**< Queue expanded when the primary is empty */
+};
+
+/**
+ * @brief Breadth first flood fill that registers the border pixels
+ * of a segment, shared by BorderSegmentExtractor, DistantSegmentExtractor
+ * and DistantSegmentExtractorV2.
+ *
+ *  Pixels are expanded from the primary queue, and from the secondary
+ * one when the primary is empty. Each neighbor inside the image
+ * is given to Policy, which marks the search mask and chooses
+ * the queue of the neighbor:
+ *
+ *    int seedAux() const;
+ *    int visit(unsigned neighbor, int aux, ushort intensity,
+ *              const SearchMask &mask, ushort &stamp,
+ *              bool &isBorder, int *nextAux) const;
+ *
+ *  Neighbors are read by row pointer offsets; the search mask is
+ * padded with outside stamps (SearchMask) so there are no bounds tests.
+ * Queues are Segmentation::floodQueue, no allocation is done after
+ * they warm up.
+ */
+template<class Policy>
+void floodFillBorder(const Policy &policy, Segmentation *segmentation,
+                     Segment *seg, const Mat &img16bits,
+                     unsigned maxSampleSize,
+                     unsigned row, unsigned col)
+{
+    SearchMask &searchMask = segmentation->searchMask;
+    FloodFillQueue &q = segmentation->floodQueue[0],
+                   &q2 = segmentation->floodQueue[1];
+
+    const int maskStep = searchMask.step(),
+              imgStep = img16bits.step1();
+    ushort *mask = searchMask.origin();
+    const ushort *img = img16bits.ptr<ushort>(0);
+
+    int maskOffset[8], imgOffset[8];
+    for(unsigned neighbor = 0 ; neighbor < 8 ; neighbor++)
+    {
+        maskOffset[neighbor] = Segmentation::neighborRow[neighbor]*maskStep + Segmentation::neighborCol[neighbor];
+        imgOffset[neighbor] = Segmentation::neighborRow[neighbor]*imgStep + Segmentation::neighborCol[neighbor];
+    }
+
+#ifdef SEGMENTATION_SEARCH_DEBUG
+    Mat &imgDebug = segmentation->imgDebug;
+#endif
+
+    // Add first element
+    q.clear();
+    q2.clear();
+    q.push(FloodFillItem(row,col,policy.seedAux()));
+    mask[row*maskStep + col] = searchMask.closedStamp();
+
+    while((!q.empty() || !q2.empty())
+          && seg->N < maxSampleSize)
+    {
+        FloodFillItem e = q.empty() ? q2.popFront() : q.popFront();
+
+        ushort *pMask = mask + e.row*maskStep + e.col;
+        const ushort *pImg = img + e.row*imgStep + e.col;
+
+        bool isBorder = false;
+
+        // Seach the neighbor pixels
+        for(unsigned neighbor = 0 ; neighbor < 8 ; neighbor++)
+        {
+            ushort &stamp = pMask[maskOffset[neighbor]];
+
+            // If neighbor isn't on image
+            if(searchMask.isOutside(stamp))
+                continue;
+
+            int nextAux,
+                push = policy.visit(neighbor, e.aux, pImg[imgOffset[neighbor]],
+                                    searchMask, stamp, isBorder, &nextAux);
+
+            if(push == FLOOD_FILL_SKIP)
+                continue;
+
+            unsigned nextRow = e.row + Segmentation::neighborRow[neighbor],
+                     nextCol = e.col + Segmentation::neighborCol[neighbor];
+
+            // Register new querry
+            if(push == FLOOD_FILL_PRIMARY)
+                q.push(FloodFillItem(nextRow,nextCol,nextAux));
+            else
+                q2.push(FloodFillItem(nextRow,nextCol,nextAux));
+
+        #ifdef SEGMENTATION_SEARCH_DEBUG
+            imgDebug.at<Vec3b>(nextRow, nextCol) = push == FLOOD_FILL_PRIMARY ?
+                        Vec3b(255,0,0) : Vec3b(0,0,255);
+        #endif
+        }
+
+        if(isBorder) // I'm a boarder
+        {
+            row = e.row;
+            col = e.col;
+
+            // Register element
+            seg->addPixel(row,col,*pImg);
+
+            // Take min max col and row
+            if(seg->MRow < row)
+                seg->MRow = row;
+            if(seg->mRow > row)
+                seg->mRow = row;
+            if(seg->MCol < col)
+                seg->MCol = col;
+            if(seg->mCol > col)
+                seg->mCol = col;
+
+        #ifdef SEGMENTATION_SEARCH_DEBUG
+            imgDebug.at<Vec3b>(row, col) = Vec3b(0,255,0);
+        #endif
+        }
+    }
+}
+
+#endif // FLOODFILL_H
@@ -0,0 +1,32 @@
+#include "FloodFillQueue.h"
+#include "Segmentation.h"
+
+#include <iostream>
+
+FloodFillQueue::FloodFillQueue(unsigned capacity):
+    m_head(0), m_size(0)
+{
+    unsigned c = 1;
+    while(c < capacity) c<<=1;
+
+    m_items.resize(c);
+    m_mask = c-1;
+}
+
+/**
+ * @brief Double the capacity, keeping the items order.
+ */
+void FloodFillQueue::grow()
+{
+    #ifdef SEGMENTATION_MEMORORY_DEBUG
+        cout << "FloodFillQueue: Allocating more " << m_items.size() << " items!!" << endl;
+    #endif
+
+    vector<FloodFillItem> items(m_items.size()*2);
+    for(unsigned i = 0 ; i < m_size; i++)
+        items[i] = m_items[(m_head+i) & m_mask];
+
+    m_items.swap(items);
+    m_head = 0;
+    m_mask = m_items.size()-1;
+}
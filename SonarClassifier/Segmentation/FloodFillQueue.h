@@ -0,0 +1,78 @@
+#ifndef FLOODFILLQUEUE_H
+#define FLOODFILLQUEUE_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Pixel waiting to be expanded by a flood fill,
+ * aux is the extractor data (jump distance, search direction).
+ */
+struct FloodFillItem
+{
+    unsigned short row, col;
+    int aux;
+
+    FloodFillItem(){}
+    FloodFillItem(unsigned row, unsigned col, int aux):
+        row(row),col(col),aux(aux){}
+};
+
+/**
+ * @brief Ring buffer used as queue (push/popFront) or
+ * stack (push/popBack) by the segment extractors.
+ *  It's owned by Segmentation and reused by all createSegment
+ * calls, it only grows (doubling) when a segment is bigger than
+ * any other seen before.
+ */
+class FloodFillQueue
+{
+    vector<FloodFillItem> m_items;
+    unsigned m_head, m_size,
+             m_mask; // Capacity - 1, capacity is power of 2
+
+    void grow();
+
+public:
+    FloodFillQueue(unsigned capacity=4096);
+
+    void clear()
+    {
+        m_head = m_size = 0;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    unsigned size() const
+    {
+        return m_size;
+    }
+
+    void push(const FloodFillItem &item)
+    {
+        if(m_size == m_items.size())
+            grow();
+        m_items[(m_head+m_size) & m_mask] = item;
+        m_size++;
+    }
+
+    FloodFillItem popFront()
+    {
+        FloodFillItem item = m_items[m_head];
+        m_head = (m_head+1) & m_mask;
+        m_size--;
+        return item;
+    }
+
+    FloodFillItem popBack()
+    {
+        m_size--;
+        return m_items[(m_head+m_size) & m_mask];
+    }
+};
+
+#endif // FLOODFILLQUEUE_H
@@ -0,0 +1,80 @@
+#include "SearchMask.h"
+
+const ushort SearchMask::OUTSIDE_STAMP;
+
+SearchMask::SearchMask():
+    m_origin(0x0), m_step(0),
+    m_free(0), m_open(1), m_closed(2),
+    rows(0), cols(0)
+{
+}
+
+/**
+ * @brief Start a new epoch, all pixels become free.
+ * Memory is allocated only if the image size changed.
+ */
+void SearchMask::reset(unsigned rows, unsigned cols)
+{
+    if(this->rows != (int)rows || this->cols != (int)cols || m_origin == 0x0)
+    {
+        this->rows = rows;
+        this->cols = cols;
+
+        m_stamps = Mat(rows+2, cols+2, CV_16UC1, Scalar(OUTSIDE_STAMP));
+        m_stamps(Rect(1,1,cols,rows)).setTo(Scalar(0));
+
+        m_step = m_stamps.step1();
+        m_origin = m_stamps.ptr<ushort>(1) + 1;
+
+        m_free = 0;
+    }else if(m_free + 5 >= OUTSIDE_STAMP)
+    {
+        // Stamps wrapped, clear them
+        m_stamps(Rect(1,1,cols,rows)).setTo(Scalar(0));
+        m_free = 0;
+    }else
+    {
+        // Older stamps are all <= m_closed < new m_free
+        m_free += 3;
+    }
+
+    m_open = m_free + 1;
+    m_closed = m_free + 2;
+}
+
+SearchMaskMark SearchMask::get(unsigned row, unsigned col) const
+{
+    ushort stamp = m_origin[(int)row*m_step + (int)col];
+
+    if(stamp == m_closed) return SEARCH_MASK_CLOSED;
+    if(stamp == m_open) return SEARCH_MASK_OPEN;
+    if(stamp == OUTSIDE_STAMP) return SEARCH_MASK_OUTSIDE;
+    return SEARCH_MASK_FREE;
+}
+
+void SearchMask::set(unsigned row, unsigned col, SearchMaskMark mark)
+{
+    ushort &stamp = m_origin[(int)row*m_step + (int)col];
+
+    switch(mark)
+    {
+    case SEARCH_MASK_CLOSED: stamp = m_closed; break;
+    case SEARCH_MASK_OPEN: stamp = m_open; break;
+    case SEARCH_MASK_OUTSIDE: stamp = OUTSIDE_STAMP; break;
+    default: stamp = m_free; break;
+    }
+}
+
+/**
+ * @brief Convert to a 8 bits mask with SearchMaskMark values (debug).
+ */
+void SearchMask::toMat(Mat &mask8bits) const
+{
+    mask8bits = Mat(rows, cols, CV_8UC1, Scalar(SEARCH_MASK_FREE));
+    for(int row = 0 ; row < rows; row++)
+    {
+        uchar *m = mask8bits.ptr<uchar>(row);
+        for(int col = 0 ; col < cols; col++)
+            m[col] = get(row,col);
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef SEARCHMASK_H
+#define SEARCHMASK_H
+
+#include <opencv2/core/core.hpp>
+
+using namespace cv;
+
+/**
+ * @brief Marks of a search mask pixel.
+ */
+enum SearchMaskMark
+{
+    SEARCH_MASK_FREE = 0,       /**< Not visited */
+    SEARCH_MASK_OPEN = 127,     /**< Visited, not closed (OrderedBorderSegmentExtractor) */
+    SEARCH_MASK_OUTSIDE = 254,  /**< Padding around the image */
+    SEARCH_MASK_CLOSED = 255    /**< Visited */
+};
+
+/**
+ * @brief Visit mask of the segment extraction.
+ *
+ *  Each pixel keeps a 16 bits stamp. Every reset() starts a new
+ * epoch with three stamps (free, open, closed), greater than all
+ * stamps of older epochs, so all old marks read as free and
+ * clearing the mask is just a stamp increment. The stamps are only
+ * cleared when they wrap, once every ~20000 frames.
+ *  The mask has one pixel of padding stamped as outside, so flood
+ * fills can test neighbors by offset without bounds tests. It's
+ * allocated again only when the image size changes.
+ */
+class SearchMask
+{
+    Mat m_stamps;       // (rows+2) x (cols+2) CV_16UC1
+    ushort *m_origin;   // Stamp of pixel (0,0)
+    int m_step;         // Row step in stamps
+
+    ushort m_free, m_open, m_closed; // Stamps of current epoch
+
+public:
+    static const ushort OUTSIDE_STAMP = 0xFFFF;
+
+    int rows, cols;
+
+    SearchMask();
+
+    void reset(unsigned rows, unsigned cols);
+
+    /** @brief Stamp of pixel (0,0), padding is at negative offsets */
+    ushort *origin()
+    {
+        return m_origin;
+    }
+
+    int step() const
+    {
+        return m_step;
+    }
+
+    bool isFree(ushort stamp) const
+    {
+        return stamp <= m_free;
+    }
+
+    bool isOpen(ushort stamp) const
+    {
+        return stamp == m_open;
+    }
+
+    bool isClosed(ushort stamp) const
+    {
+        return stamp == m_closed;
+    }
+
+    bool isOutside(ushort stamp) const
+    {
+        return stamp == OUTSIDE_STAMP;
+    }
+
+    /** @brief Free or open */
+    bool isNotClosed(ushort stamp) const
+    {
+        return stamp <= m_open;
+    }
+
+    ushort openStamp() const
+    {
+        return m_open;
+    }
+
+    ushort closedStamp() const
+    {
+        return m_closed;
+    }
+
+    SearchMaskMark get(unsigned row, unsigned col) const;
+    void set(unsigned row, unsigned col, SearchMaskMark mark);
+
+    void toMat(Mat &mask8bits) const;
+};
+
+#endif // SEARCHMASK_H
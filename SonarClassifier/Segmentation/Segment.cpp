@@ -1,6 +1,30 @@
 #include "Segment.h"
 #include <iostream>
+#include <cstring>
 
+const unsigned Segment::NO_SIZE_LIMIT;
+
+Segment::Segment(SegmentArena *arena):
+    result(arena), countor(arena),
+    N(0), NCountor(0),
+    mRow(99999), MRow(0), mCol(99999), MCol(0)
+{
+}
+
+/**
+ * @brief Initialize the segment to be extracted again,
+ * its storage is kept if it's still valid.
+ */
+void Segment::clear()
+{
+    N = NCountor = 0;
+    MCol = MRow = 0;
+    mRow = mCol = 99999;
+
+    moments.clear();
+    result.clear();
+    countor.clear();
+}
 
 /**
  * @brief Draw pixels of segment on image BGR
@@ -13,13 +37,12 @@ void Segment::drawSegment(Mat &bgrImg, const Scalar &color)
     for(unsigned i = 0 ; i < N ; i++)
     {
         // Here:
-        //   result.at<ushort>(0, k ) - Acess the row of K-th pixel found by floodfill search
-        //   result.at<ushort>(1, k ) - Acess the col of K-th pixel found by floodfill search
-        //   result.at<ushort>(2, k ) - Acess the pixel intensity of K-th pixel found by floodfill search
-        /// @todo - Acessing uchar Mat::data[] is faster than at<type>()
+        //   result.row[k] - Acess the row of K-th pixel found by floodfill search
+        //   result.col[k] - Acess the col of K-th pixel found by floodfill search
+        //   result.intensity[k] - Acess the pixel intensity of K-th pixel found by floodfill search
 
-        unsigned pixelRow = result.at<ushort>(0,i),
-                pixelCol = result.at<ushort>(1,i),
+        unsigned pixelRow = result.row[i],
+                pixelCol = result.col[i],
                 pixelColStart = pixelCol*3;
 
         if(pixelRow < bgrImg.rows &&
@@ -43,8 +66,8 @@ void Segment::toBinMatrix(Mat &mBin)
 
     for(unsigned i = 0; i < N;i++)
     {
-        mBin.at<uchar>( result.at<ushort>(0,i) -mRow,
-                        result.at<ushort>(1,i) -mCol) = 255u;
+        mBin.at<uchar>( result.row[i] -mRow,
+                        result.col[i] -mCol) = 255u;
     }
 }
 
@@ -59,8 +82,8 @@ void Segment::toCVContour(Mat &mBin)
 
     for(unsigned i = 0; i < NCountor;i++)
     {
-        mBin.at<int>( i, 0) = countor.at<ushort>(1,i);
-        mBin.at<int>( i, 1) = countor.at<ushort>(0,i);
+        mBin.at<int>( i, 0) = countor.col[i];
+        mBin.at<int>( i, 1) = countor.row[i];
     }
 }
 
@@ -74,8 +97,8 @@ void Segment::toCVContour(vector<Point> &contour)
     contour.resize(NCountor);
     for(unsigned i = 0; i < NCountor;i++)
     {
-        contour[i].x = this->countor.at<ushort>(1,i);
-        contour[i].y = this->countor.at<ushort>(0,i);
+        contour[i].x = this->countor.col[i];
+        contour[i].y = this->countor.row[i];
     }
 }
 
@@ -121,19 +144,32 @@ void Segment::rotateSegment(float degreeAng, float cx, float cy)
 
     for(unsigned i=0; i < N ; i++)
     {
-        float ny = result.at<ushort>(0,i)-cy, // Acess pixel's row
-              nx = result.at<ushort>(1,i)-cx; // Acess pixel's col
+        float ny = result.row[i]-cy, // Acess pixel's row
+              nx = result.col[i]-cx; // Acess pixel's col
 
-        result.at<ushort>(0,i) = // Access the row
+        result.row[i] = // Access the row
                 roundf(  // It's important! round the values!!
                          nx*sinA + ny*cosA + cy  // Row <-> y
                       );
 
-        result.at<ushort>(1,i) = // Access the col
+        result.col[i] = // Access the col
                 roundf(  // It's important! round the values!!
                          nx*cosA - ny*sinA + cx // Col <-> x
                     );
     }
+
+    updateMoments();
+}
+
+/**
+ * @brief Compute moments again from result pixels,
+ * when they were changed without addPixel.
+ */
+void Segment::updateMoments()
+{
+    moments.clear();
+    for(unsigned i=0; i < N ; i++)
+        moments.add(result.row[i], result.col[i], result.intensity[i]);
 }
 
 
@@ -145,24 +181,14 @@ void Segment::rotateSegment(float degreeAng, float cx, float cy)
  */
 void Segment::merge(Segment *seg)
 {
+    result.reserve(N+seg->N, N);
 
-    if(result.cols < N+seg->N)
-    {
-        Mat newMat(3,N+seg->N,CV_8UC1);
-
-             result(Rect( 0 , 0 ,  N , 3 )).copyTo
-            (newMat(Rect( 0 , 0 ,  N , 3 )));
-
-        seg->result(Rect( 0 , 0 ,seg->N, 3 )).copyTo
-            (newMat(Rect( N , 0 ,seg->N, 3 )));
-        result = newMat;
-    }else
-    {
-        seg->result(Rect( 0 , 0 ,seg->N, 3 )).copyTo
-            (result(Rect( N , 0 ,seg->N, 3 )));
-    }
+    memcpy(result.row+N, seg->result.row, seg->N*sizeof(ushort));
+    memcpy(result.col+N, seg->result.col, seg->N*sizeof(ushort));
+    memcpy(result.intensity+N, seg->result.intensity, seg->N*sizeof(ushort));
 
     N +=seg->N;
+    moments.add(seg->moments);
 
     mRow = std::min(mRow,seg->mRow);
     MRow = std::max(MRow,seg->MRow);
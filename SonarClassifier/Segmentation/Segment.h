@@ -7,19 +7,73 @@
 
 #include <vector>
 
+#include "SegmentPixels.h"
+#include "SegmentMoments.h"
+
 using namespace std;
 using namespace cv;
 
 class Segment
 {
 public:
+    static const unsigned NO_SIZE_LIMIT = 0xFFFFFFFF; /**< maxSampleSize of extractors without limit */
 
-    Mat result, /**< 1 channel 3xN matrix , result[0,:] = pixel row found , row[1,:] = pixel col found and result[2,:] = pixel intensity of pixel found */
-        countor;
+    SegmentPixels result, /**< Pixels found, result.row[k], result.col[k] and result.intensity[k] of k-th pixel */
+                  countor;
 
     unsigned N, NCountor; /**< Pixel found count */
     unsigned mRow, MRow, mCol, MCol;
 
+    SegmentMoments moments; /**< Moments of result pixels, updated by addPixel */
+
+    Segment(SegmentArena *arena=0x0);
+
+    void clear();
+
+    /** @brief Register a pixel, growing the storage if needed */
+    void addPixel(unsigned row, unsigned col, unsigned short intensity)
+    {
+        if(N == result.capacity())
+            result.reserve(N+1,N);
+
+        result.row[N] = row;
+        result.col[N] = col;
+        result.intensity[N] = intensity;
+        N++;
+
+        moments.add(row,col,intensity);
+    }
+
+    /** @brief Register a countor pixel, growing the storage if needed */
+    void addCountorPixel(unsigned row, unsigned col, unsigned short intensity)
+    {
+        if(NCountor == countor.capacity())
+            countor.reserve(NCountor+1,NCountor);
+
+        countor.row[NCountor] = row;
+        countor.col[NCountor] = col;
+        countor.intensity[NCountor] = intensity;
+        NCountor++;
+    }
+
+    /** @brief 3xN CV_16UC1 view: rows, cols and intensities */
+    Mat pixels() const
+    {
+        return result.view(N);
+    }
+
+    /** @brief 2xN CV_16UC1 view: rows and cols */
+    Mat positions() const
+    {
+        return result.view(N,0,2);
+    }
+
+    /** @brief 1xN CV_16UC1 view of intensities */
+    Mat intensities() const
+    {
+        return result.view(N,2,1);
+    }
+
     void drawSegment(Mat &bgrImg, const Scalar &color);
     void toBinMatrix(Mat &mBin);
     void toCVContour(Mat &mBin);
@@ -31,6 +85,7 @@ public:
     void drawSegmentBox(Mat &bgrImg, const Scalar &color);
 
     void rotateSegment(float degreeAng, float cx, float cy);
+    void updateMoments();
 
     void merge(Segment *seg);
 
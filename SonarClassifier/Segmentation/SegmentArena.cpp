@@ -0,0 +1,73 @@
+#include "SegmentArena.h"
+#include "Segmentation.h"
+
+#include <iostream>
+#include <algorithm>
+
+SegmentArena::SegmentArena(size_t chunkSize):
+    m_used(0), m_epoch(0)
+{
+    addChunk(chunkSize);
+}
+
+SegmentArena::~SegmentArena()
+{
+    for(unsigned i = 0 ; i < m_chunks.size(); i++)
+        delete [] m_chunks[i];
+}
+
+void SegmentArena::addChunk(size_t size)
+{
+    #ifdef SEGMENTATION_MEMORORY_DEBUG
+        cout << "SegmentArena: Allocating chunk of " << size << " pixels!!" << endl;
+    #endif
+
+    m_chunks.push_back(new unsigned short[size]);
+    m_chunkSizes.push_back(size);
+    m_used = 0;
+}
+
+/**
+ * @brief Take n elements, aligned on 16 bytes. A new chunk (at
+ * least twice the last one) is added when the last one is full.
+ */
+unsigned short *SegmentArena::allocate(size_t n)
+{
+    n = (n+7) & ~(size_t)7;
+
+    if(m_used + n > m_chunkSizes.back())
+        addChunk(std::max(n, m_chunkSizes.back()*2));
+
+    unsigned short *p = m_chunks.back() + m_used;
+    m_used+= n;
+    return p;
+}
+
+/**
+ * @brief Free all allocations, starting a new epoch.
+ */
+void SegmentArena::reset()
+{
+    if(m_chunks.size() > 1)
+    {
+        size_t total = capacity();
+
+        for(unsigned i = 0 ; i < m_chunks.size(); i++)
+            delete [] m_chunks[i];
+        m_chunks.clear();
+        m_chunkSizes.clear();
+
+        addChunk(total);
+    }
+
+    m_used = 0;
+    m_epoch++;
+}
+
+size_t SegmentArena::capacity() const
+{
+    size_t total = 0;
+    for(unsigned i = 0 ; i < m_chunkSizes.size(); i++)
+        total+= m_chunkSizes[i];
+    return total;
+}
@@ -0,0 +1,47 @@
+#ifndef SEGMENTARENA_H
+#define SEGMENTARENA_H
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * @brief Bump allocator of segment pixels owned by Segmentation.
+ *
+ *  Memory is only given back all together by reset(), at each new
+ * frame (Segmentation::resetMask). When a frame needed more than one
+ * chunk they're joined in a single bigger chunk, so after a few
+ * frames the extraction doesn't allocate anything.
+ *  Storage taken in older epochs is invalid, SegmentPixels checks
+ * epoch() before reusing it.
+ */
+class SegmentArena
+{
+    vector<unsigned short*> m_chunks;
+    vector<size_t> m_chunkSizes;
+    size_t m_used; // Elements used in last chunk
+    unsigned m_epoch;
+
+    // Not copyable
+    SegmentArena(const SegmentArena &);
+    SegmentArena &operator=(const SegmentArena &);
+
+    void addChunk(size_t size);
+
+public:
+    SegmentArena(size_t chunkSize = 1<<18);
+    ~SegmentArena();
+
+    unsigned short *allocate(size_t n);
+    void reset();
+
+    unsigned epoch() const
+    {
+        return m_epoch;
+    }
+
+    size_t capacity() const;
+};
+
+#endif // SEGMENTARENA_H
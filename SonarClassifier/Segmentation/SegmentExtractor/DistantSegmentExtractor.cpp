@@ -1,28 +1,62 @@
 #include "DistantSegmentExtractor.h"
 
-#include <queue>
 #include "Segmentation/Segmentation.h"
+#include "Segmentation/FloodFill.h"
 
 using namespace std;
 
-class SegDistSearchStruct
+/**
+ * @brief Pixels with intensity >= rhoRecursive are expanded first,
+ * dark pixels (> 5) can be jumped up to searchDistance pixels
+ * away from the segment. A segment pixel with a jumped neighbor
+ * is a border pixel.
+ */
+class DistantFillPolicy
 {
+    unsigned rhoRecursive;
+    int searchDistance;
 public:
-    unsigned row,
-             col;
-    int      dist;
-    SegDistSearchStruct(unsigned row, unsigned col, int dist):
-        row(row),col(col),dist(dist){}
-    void get(unsigned &prow, unsigned &pcol, int &pdist)
+    DistantFillPolicy(unsigned rhoRecursive, int searchDistance):
+        rhoRecursive(rhoRecursive), searchDistance(searchDistance){}
+
+    int seedAux() const
     {
-        prow = row;
-        pcol = col;
-        pdist = dist;
+        return searchDistance;
+    }
+
+    int visit(unsigned neighbor, int dist, ushort intensity,
+              const SearchMask &mask, ushort &stamp, bool &isBorder, int *nextAux) const
+    {
+        // If we can visit this neighbor pixel
+        if(mask.isClosed(stamp))
+            return FLOOD_FILL_SKIP;
+
+        if(intensity >= rhoRecursive)
+        {
+            // Register the visit of pixel
+            stamp = mask.closedStamp();
+            *nextAux = searchDistance;
+            return FLOOD_FILL_PRIMARY;
+
+        }else if(dist > 0 && intensity > 5) // If we can jump for then
+        {
+            // Register the visit of pixel
+            stamp = mask.closedStamp();
+
+            if( dist == searchDistance) // I'm a boarder
+            {
+                isBorder = true;
+            }
+
+            *nextAux = dist-1;
+            return FLOOD_FILL_SECONDARY;
+        }
+        return FLOOD_FILL_SKIP;
     }
 };
 
 DistantSegmentExtractor::DistantSegmentExtractor():
-    maxSampleSize(1200),rhoRecursive(215),searchDistance(3)
+    maxSampleSize(Segment::NO_SIZE_LIMIT),rhoRecursive(215),searchDistance(3)
 {
 }
 
@@ -37,134 +71,12 @@ void DistantSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigne
     }
 #endif
 
-    // Realocate memory if necsessary
-    if(seg->result.rows < 3 || seg->result.cols < maxSampleSize)
-    {
-        #ifdef SEGMENTATION_MEMORORY_DEBUG
-            cout << "createSegmentDist: Allocating memory for segments!!" << endl;
-        #endif
-        seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
-
     // Initialize segment
-    seg->N = 0;
-    seg->MCol = seg->MRow = 0;
-    seg->mRow = seg->mCol = 99999;
-
-    // Initialize queue of BFS
-    queue< SegDistSearchStruct > q, afterBoardQ;
-    int dist=0;
-
-    // Add first element
-    q.push(SegDistSearchStruct(row,col,searchDistance));
-    searchMask->at<uchar>(row,col) = 255u;
+    seg->clear();
 
-    bool isBorder=false;
+    floodFillBorder(DistantFillPolicy(rhoRecursive,searchDistance),m_seg,
+                    seg,img16bits,maxSampleSize,row,col);
 
-    while((!q.empty() || !afterBoardQ.empty())
-          && seg->N < maxSampleSize)
-    {
-        if(!q.empty())
-        {
-            q.front().get(row,col,dist);
-            q.pop();
-        }else
-        {
-            afterBoardQ.front().get(row,col,dist);
-            afterBoardQ.pop();
-        }
-
-        isBorder = false;
-
-        // Seach the neighbor pixels
-        for(unsigned neighbor = 0 ; neighbor < 8 && seg->N < maxSampleSize ; neighbor++)
-        {
-            unsigned nextRow = row + Segmentation::neighborRow[neighbor],
-                     nextCol = col + Segmentation::neighborCol[neighbor];
-
-            // If neighbor isn't on image (unsigned comparison)
-            if(nextRow >= img16bits.rows ||
-               nextCol >= img16bits.cols)
-                continue;
-
-            // If we can visit this neighbor pixel
-            if(searchMask->at<uchar>(nextRow,nextCol) != 255)
-            {
-                if(img16bits.at<ushort>(nextRow , nextCol) >= rhoRecursive)
-                {
-                    // Register the visit of pixel
-                    searchMask->at<uchar>(nextRow,nextCol) = 255;
-
-                    // Register new querry
-                    q.push(SegDistSearchStruct(nextRow , nextCol,searchDistance));
-
-
-                #ifdef SEGMENTATION_SEARCH_DEBUG
-//                    imgDebug.at<Vec3b>(nextRow, nextCol) = Vec3b(255,0,0);
-                    unsigned debCol = nextCol*3;
-                    imgDebug.at<uchar>(nextRow, debCol) = 255;
-                    imgDebug.at<uchar>(nextRow, debCol+1) = 0;
-                    imgDebug.at<uchar>(nextRow, debCol+2) = 0;
-                #endif
-
-                }else if(dist > 0 && img16bits.at<ushort>(nextRow , nextCol) > 5) // If we can jump for then
-                {
-                    // Register the visit of pixel
-                    searchMask->at<uchar>(nextRow,nextCol) = 255;
-
-                    if( dist == searchDistance) // I'm a boarder
-                    {
-                        isBorder = true;
-                    }
-
-                    // Register new querry
-                    afterBoardQ.push(SegDistSearchStruct(nextRow , nextCol,dist-1));
-
-                #ifdef SEGMENTATION_SEARCH_DEBUG
-//                    imgDebug.at<Vec3b>(nextRow, nextCol) = Vec3b(0,0,255);
-
-                    unsigned debCol = nextCol*3;
-                    imgDebug.at<uchar>(nextRow, debCol) = 0;
-                    imgDebug.at<uchar>(nextRow, debCol+1) = 0;
-                    imgDebug.at<uchar>(nextRow, debCol+2) = 255;
-                #endif
-
-                }
-            }
-        }
-
-        if(isBorder) // I'm a boarder
-        {
-            // Register element
-            seg->result.at<ushort>(0,seg->N) = row;
-            seg->result.at<ushort>(1,seg->N) = col;
-            seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-            seg->N++;
-
-            // Take min max col and row
-            if(seg->MRow < row)
-                seg->MRow = row;
-            if(seg->mRow > row)
-                seg->mRow = row;
-            if(seg->MCol < col)
-                seg->MCol = col;
-            if(seg->mCol > col)
-                seg->mCol = col;
-
-        #ifdef SEGMENTATION_SEARCH_DEBUG
-//            imgDebug.at<Vec3b>(row, col) = Vec3b(0,255,0);
-            unsigned debCol = col*3;
-            imgDebug.at<uchar>(row, debCol) = 0;
-            imgDebug.at<uchar>(row, debCol+1) = 255;
-            imgDebug.at<uchar>(row, debCol+2) = 0;
-        #endif
-        }
-
-    #ifdef SEGMENTATION_SEARCH_DEBUG
-//        imshow("createSegDist Search Debug", imgDebug);
-//        waitKey(1);
-    #endif
-    }
 #ifdef SEGMENTATION_SEARCH_DEBUG
     imshow("createSegDist Search Debug", imgDebug);
     cout << "Creat seg Dist end!!" << endl;
@@ -178,7 +90,7 @@ void DistantSegmentExtractor::load(ConfigLoader &config)
 
     if(config.getInt("General","MaxSampleSize",&vi))
     {
-        maxSampleSize = vi;
+        maxSampleSize = vi > 0 ? vi : Segment::NO_SIZE_LIMIT;
     }
 
     if(config.getInt("DistantSegmentExtractor","rhoRecursive",&vi))
@@ -1,28 +1,70 @@
 #include "DistantSegmentExtractorV2.h"
 
-#include <queue>
-#include <stack>
 #include "Segmentation/Segmentation.h"
+#include "Segmentation/FloodFill.h"
 
 using namespace std;
 
-class SegDistSearchStruct
+/**
+ * @brief Pixels with intensity >= rhoRecursive are segment pixels,
+ * dark pixels (> 5) can be jumped up to searchDistance pixels away
+ * (distances x10, diagonal step costs 14). A segment pixel with
+ * a jumpable neighbor is a border pixel.
+ */
+class DistantV2FillPolicy
 {
+    unsigned rhoRecursive;
+    int searchDistanceX10;
 public:
-    unsigned row,
-             col;
-    int      dist;
-    SegDistSearchStruct(unsigned row, unsigned col, int dist):
-        row(row),col(col),dist(dist){}
-    void get(unsigned &prow, unsigned &pcol, int &pdist)
+    DistantV2FillPolicy(unsigned rhoRecursive, int searchDistance):
+        rhoRecursive(rhoRecursive), searchDistanceX10(searchDistance*10){}
+
+    int seedAux() const
+    {
+        return searchDistanceX10;
+    }
+
+    int visit(unsigned neighbor, int dist, ushort intensity,
+              const SearchMask &mask, ushort &stamp, bool &isInsideBorder, int *nextAux) const
     {
-        prow = row;
-        pcol = col;
-        pdist = dist;
+        if(intensity >= rhoRecursive)
+        {
+            // If can not visited, register a visit
+            if(!mask.isClosed(stamp))
+            {
+                // Register visit of pixel
+                stamp = mask.closedStamp();
+                *nextAux = searchDistanceX10;
+                return FLOOD_FILL_PRIMARY;
+            }
+
+        }else if(dist > 0 && intensity > 5) // If we can jump over then
+        {
+            if( dist == searchDistanceX10) // I'm inside and my neighbor is outside
+            {
+                // I'm inside board and my neighboard is outside board
+                isInsideBorder = true;
+            }
+
+            // If can not visited, register a visit
+            if(!mask.isClosed(stamp))
+            {
+                // Register visit of pixel
+                stamp = mask.closedStamp();
+
+                if(neighbor%2 == 0) // It's horizontal or vertical neighbor!
+                    *nextAux = dist-10;
+                else // It's a diagonal neighbor!
+                    *nextAux = dist-14;
+                return FLOOD_FILL_PRIMARY;
+            }
+        }
+        return FLOOD_FILL_SKIP;
     }
 };
 
-DistantSegmentExtractorV2::DistantSegmentExtractorV2()
+DistantSegmentExtractorV2::DistantSegmentExtractorV2():
+    maxSampleSize(Segment::NO_SIZE_LIMIT)
 {
 }
 
@@ -57,126 +99,11 @@ void DistantSegmentExtractorV2::createSegment(Segment *seg, Mat img16bits, unsig
         }
     #endif
 
-        // Realocate memory if necsessary
-        if(seg->result.rows < 3 || seg->result.cols < maxSampleSize)
-        {
-            #ifdef SEGMENTATION_MEMORORY_DEBUG
-                cout << "createSegmentDist: Allocating memory for segments!!" << endl;
-            #endif
-            seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-        }
-
         // Initialize segment
-        seg->N = 0;
-        seg->MCol = seg->MRow = 0;
-        seg->mRow = seg->mCol = 99999;
-
-        // Initialize queue of BFS
-        queue< SegDistSearchStruct > q;
+        seg->clear();
 
-        int dist=0,searchDistanceX10=searchDistance*10;
-
-        // Add first element
-        q.push(SegDistSearchStruct(row,col,searchDistanceX10));
-        searchMask->at<uchar>(row,col) = 255u;
-
-        bool isInsideBorder=false;
-
-        while(!q.empty() && seg->N < maxSampleSize)
-        {
-            q.front().get(row,col,dist);
-            q.pop();
-            #ifdef SEGMENTATION_SEARCH_DEBUG
-//                imgDebug.at<Vec3b>(row, col) = Vec3b(255,0,255); // Magenta
-//                imshow("createSegDist Search Debug", imgDebug);
-            #endif
-
-            // Seach the neighbor pixels
-            for(unsigned neighbor = 0 ; neighbor < 8 && seg->N < maxSampleSize ; neighbor++)
-            {
-                unsigned nextRow = row + Segmentation::neighborRow[neighbor],
-                         nextCol = col + Segmentation::neighborCol[neighbor];
-
-                // If neighbor isn't on image (unsigned comparison)
-                if(nextRow >= img16bits.rows ||
-                   nextCol >= img16bits.cols)
-                    continue;
-
-                if(img16bits.at<ushort>(nextRow , nextCol) >= rhoRecursive)
-                {
-                    // If can not visited, register a visit
-                    if(searchMask->at<uchar>(nextRow,nextCol) != 255)
-                    {
-                        // Register visit of pixel
-                        searchMask->at<uchar>(nextRow,nextCol) = 255;
-                        q.push(SegDistSearchStruct(nextRow , nextCol,searchDistanceX10));
-                        #ifdef SEGMENTATION_SEARCH_DEBUG
-                            imgDebug.at<Vec3b>(nextRow, nextCol) = Vec3b(255,0,0); // Blue
-//                            imshow("createSegDist Search Debug", imgDebug);
-//                            waitKey();
-                        #endif
-                    }
-
-                }else if(dist > 0 && img16bits.at<ushort>(nextRow , nextCol) > 5) // If we can jump over then
-                {
-                    // If can not visited, register a visit
-                    if(searchMask->at<uchar>(nextRow,nextCol) != 255)
-                    {
-                        // Register visit of pixel
-                        searchMask->at<uchar>(nextRow,nextCol) = 255;
-
-                        if(neighbor%2 == 0) // It's horizontal or vertical neighbor!
-                            q.push(SegDistSearchStruct(nextRow , nextCol,dist-10));
-                        else // It's a diagonal neighbor!
-                            q.push(SegDistSearchStruct(nextRow , nextCol,dist-14));
-
-                        #ifdef SEGMENTATION_SEARCH_DEBUG
-                            imgDebug.at<Vec3b>(nextRow, nextCol) = Vec3b(0,0,255); // Red
-//                            imshow("createSegDist Search Debug", imgDebug);
-//                            waitKey();
-                        #endif
-                    }
-
-                    if( dist == searchDistanceX10) // I'm inside and my neighbor is outside
-                    {
-                        // I'm inside board and my neighboard is outside board
-                        isInsideBorder = true;
-                    }
-                }
-            }
-
-            if(isInsideBorder) // I'm a boarder
-            {
-                isInsideBorder = false;
-
-                // Register element
-                seg->result.at<ushort>(0,seg->N) = row;
-                seg->result.at<ushort>(1,seg->N) = col;
-                seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-                seg->N++;
-
-                // Take min max col and row
-                if(seg->MRow < row)
-                    seg->MRow = row;
-                if(seg->mRow > row)
-                    seg->mRow = row;
-                if(seg->MCol < col)
-                    seg->MCol = col;
-                if(seg->mCol > col)
-                    seg->mCol = col;
-
-                #ifdef SEGMENTATION_SEARCH_DEBUG
-                    imgDebug.at<Vec3b>(row, col) = Vec3b(0,255,0);
-//                    imshow("createSegDist Search Debug", imgDebug);
-//                    waitKey();
-                #endif
-            }
-
-        #ifdef SEGMENTATION_SEARCH_DEBUG
-//            imshow("createSegDist Search Debug", imgDebug);
-//            waitKey();
-        #endif
-        }
+        floodFillBorder(DistantV2FillPolicy(rhoRecursive,searchDistance),m_seg,
+                        seg,img16bits,maxSampleSize,row,col);
 
     #ifdef SEGMENTATION_SEARCH_DEBUG
         imshow("createSegDist Search Debug", imgDebug);
@@ -191,7 +118,7 @@ void DistantSegmentExtractorV2::load(ConfigLoader &config)
 
     if(config.getInt("General","MaxSampleSize",&vi))
     {
-        maxSampleSize = vi;
+        maxSampleSize = vi > 0 ? vi : Segment::NO_SIZE_LIMIT;
     }
 
     if(config.getInt("DistantSegmentExtractorV2","rhoRecursive",&vi))
@@ -4,7 +4,8 @@
 #include <queue>
 using namespace std;
 
-FullSegmentExtractor::FullSegmentExtractor()
+FullSegmentExtractor::FullSegmentExtractor():
+    maxSampleSize(Segment::NO_SIZE_LIMIT)
 {
 }
 
@@ -21,19 +22,7 @@ FullSegmentExtractor::FullSegmentExtractor()
 void FullSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigned row, unsigned col)
 {
     // Initialize segment
-    seg->N = 0;
-    seg->MCol = seg->MRow = 0;
-    seg->mRow = seg->mCol = 99999;
-
-    // Realocate memory if necsessary
-    if(seg->result.rows < 3 || seg->result.cols < maxSampleSize)
-    {
-        #ifdef SEGMENTATION_MEMORORY_DEBUG
-                cout << "createSegment: Allocating memory for segments!!" << endl;
-        #endif
-
-        seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
+    seg->clear();
 
     // Initialize queue of BFS
     typedef pair<unsigned, unsigned> PUU;
@@ -41,7 +30,7 @@ void FullSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigned r
 
     // Add first element
     q.push(PUU(row,col));
-    searchMask->at<uchar>(row,col) = 255;
+    searchMask->set(row,col,SEARCH_MASK_CLOSED);
 
     while(!q.empty() && seg->N < maxSampleSize)
     {
@@ -50,10 +39,7 @@ void FullSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigned r
         q.pop();
 
         // Register first element
-        seg->result.at<ushort>(0,seg->N) = row;
-        seg->result.at<ushort>(1,seg->N) = col;
-        seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-        seg->N++;
+        seg->addPixel(row,col,img16bits.at<ushort>(row,col));
 
         // Take min max col and row
         if(seg->MRow < row)
@@ -78,10 +64,10 @@ void FullSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigned r
 
             // If neighbor wasn't visited
             if(img16bits.at<ushort>(nextRow , nextCol) >= rhoRecursive
-               && searchMask->at<uchar>(nextRow,nextCol) != 255)
+               && searchMask->get(nextRow,nextCol) != SEARCH_MASK_CLOSED)
             {
                 // Register the visit of pixel
-                searchMask->at<uchar>(nextRow,nextCol) = 255;
+                searchMask->set(nextRow,nextCol,SEARCH_MASK_CLOSED);
 
                 // Register new querry
                 q.push(PUU(nextRow , nextCol));
@@ -96,7 +82,7 @@ void FullSegmentExtractor::load(ConfigLoader &config)
 
     if(config.getInt("FullSegmentExtractor","maxSampleSize",&vi))
     {
-        maxSampleSize = vi;
+        maxSampleSize = vi > 0 ? vi : Segment::NO_SIZE_LIMIT;
     }
 
     if(config.getInt("FullSegmentExtractor","rhoRecursive",&vi))
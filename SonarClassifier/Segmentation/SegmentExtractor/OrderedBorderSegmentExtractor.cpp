@@ -1,12 +1,10 @@
 #include "OrderedBorderSegmentExtractor.h"
 #include "Segmentation/Segmentation.h"
 
-#include<queue>
-#include<stack>
-
 using namespace std;
 
-OrderedBorderSegmentExtractor::OrderedBorderSegmentExtractor()
+OrderedBorderSegmentExtractor::OrderedBorderSegmentExtractor():
+    maxSampleSize(Segment::NO_SIZE_LIMIT)
 {
 }
 
@@ -28,33 +26,32 @@ void OrderedBorderSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
     cvtColor(colorImg,colorImg,CV_GRAY2BGR);
     #endif
 
-    // Realocate memory if necsessary
-    if(seg->result.rows < 3 || seg->result.cols < maxSampleSize)
-    {
-        #ifdef SEGMENTATION_MEMORORY_DEBUG
-            cout << "createBorderSegment: Allocating memory for segments!!" << endl;
-        #endif
-        seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
+    // Initialize segment
+    seg->clear();
+
+    // Neighbors by row pointer offset, the mask is padded
+    // with outside stamps so there are no bounds tests
+    const int maskStep = searchMask->step(),
+              imgStep = img16bits.step1();
+    ushort *mask = searchMask->origin();
+    const ushort *img = img16bits.ptr<ushort>(0);
 
-    if(seg->countor.rows < 3 || seg->countor.cols < maxSampleSize)
+    int maskOffset[8], imgOffset[8];
+    for(unsigned neighbor = 0 ; neighbor < 8 ; neighbor++)
     {
-        seg->countor = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
+        maskOffset[neighbor] = Segmentation::neighborRow[neighbor]*maskStep + Segmentation::neighborCol[neighbor];
+        imgOffset[neighbor] = Segmentation::neighborRow[neighbor]*imgStep + Segmentation::neighborCol[neighbor];
     }
 
-    // Initialize segment
-    seg->N = seg->NCountor = 0;
-    seg->MCol = seg->MRow = 0;
-    seg->mRow = seg->mCol = 99999;
-
-    // Initialize queue of DFS
-    typedef pair<unsigned, unsigned> PUU; // < row, col>
-    typedef pair<PUU, unsigned> PPUUU; // < <row,col>, dir>
-    stack< PPUUU > q, qBorder;
+    // Initialize stacks of DFS, aux is the search direction
+    FloodFillQueue &q = m_seg->floodQueue[0],
+                   &qBorder = m_seg->floodQueue[1];
+    q.clear();
+    qBorder.clear();
 
     // Add first element
-    q.push(PPUUU(PUU(row,col),0));
-    searchMask->at<uchar>(row,col) = 127;
+    q.push(FloodFillItem(row,col,0));
+    mask[row*maskStep + col] = searchMask->openStamp();
 
     bool isBorder;
 
@@ -62,34 +59,28 @@ void OrderedBorderSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
     {
         if(!qBorder.empty()) // Take board pixel
         {
-            PPUUU &e = qBorder.top();
-            row = e.first.first;
-            col = e.first.second;
-            unsigned neighbor = (e.second + 3)%8; // inverse - 1 (clockwise)
-
-            qBorder.pop();
+            FloodFillItem e = qBorder.popBack();
+            row = e.row;
+            col = e.col;
+            unsigned neighbor = (e.aux + 3)%8; // inverse - 1 (clockwise)
 
             #ifdef SEGEXTRAC_DRWING_DEBUG
             Vec3b &p = colorImg.at<Vec3b>(row,col);
             p[0] = 255; p[1] = 0; p[2] = 0;
             #endif
 
-            unsigned nextRow = row + Segmentation::neighborRow[neighbor],
-                     nextCol = col + Segmentation::neighborCol[neighbor];
-
-            // If neighbor exist in the image
-            if( (nextRow < img16bits.rows &&
-                 nextCol < img16bits.cols)
-                &&
-            // If neighbor wasn't closed
-               (searchMask->at<uchar>(nextRow,nextCol) <= 127)
-              // 0 = not visited, 127 = visited, 255=closed
-              )
+            const ushort *pMask = mask + row*maskStep + col;
+            const ushort *pImg = img + row*imgStep + col;
+
+            // If neighbor wasn't closed (padding is never open)
+            if(searchMask->isNotClosed(pMask[maskOffset[neighbor]]))
             {
-                if(img16bits.at<ushort>(nextRow , nextCol) >= searchThreshold)
+                if(pImg[imgOffset[neighbor]] >= searchThreshold)
                 {
                     // Register new querry
-                    q.push(PPUUU(PUU(nextRow , nextCol),(neighbor+5)%8)); // inverse + 1 (clockwise)
+                    q.push(FloodFillItem(row + Segmentation::neighborRow[neighbor],
+                                         col + Segmentation::neighborCol[neighbor],
+                                         (neighbor+5)%8)); // inverse + 1 (clockwise)
                 }
             }
         }
@@ -97,14 +88,16 @@ void OrderedBorderSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
         {
             isBorder = false;
 
-            PPUUU &e = q.top();
-            row = e.first.first;
-            col = e.first.second;
-            unsigned startNeighbor = e.second;
-            q.pop();
+            FloodFillItem e = q.popBack();
+            row = e.row;
+            col = e.col;
+            unsigned startNeighbor = e.aux;
+
+            ushort *pMask = mask + row*maskStep + col;
+            const ushort *pImg = img + row*imgStep + col;
 
             // If the pixel is closed
-            if(searchMask->at<uchar>(row,col) == 255)
+            if(searchMask->isClosed(*pMask))
                 continue;
 
             #ifdef SEGEXTRAC_DRWING_DEBUG
@@ -125,40 +118,35 @@ void OrderedBorderSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
                     firstIteration = false;
                 }
 
-                unsigned nextRow = row + Segmentation::neighborRow[neighbor],
-                         nextCol = col + Segmentation::neighborCol[neighbor];
-
-                // If neighbor do not exist in the image
-                if(nextRow >= img16bits.rows ||
-                   nextCol >= img16bits.cols)
-                    continue;
+                ushort &stamp = pMask[maskOffset[neighbor]];
 
-                // If neighbor wasn't visited
-                if(searchMask->at<uchar>(nextRow,nextCol) == 0)
+                // If neighbor wasn't visited (padding is never free)
+                if(searchMask->isFree(stamp))
                 {
-                    if(img16bits.at<ushort>(nextRow , nextCol) >= searchThreshold)
+                    if(pImg[imgOffset[neighbor]] >= searchThreshold)
                     {
                         // Register the visit of pixel
-                        searchMask->at<uchar>(nextRow,nextCol) = 127;
+                        stamp = searchMask->openStamp();
 
                         // Register new querry ( L_querry = +6 )
-                        q.push(PPUUU(PUU(nextRow , nextCol),(neighbor+6)%8));
+                        q.push(FloodFillItem(row + Segmentation::neighborRow[neighbor],
+                                             col + Segmentation::neighborCol[neighbor],
+                                             (neighbor+6)%8));
                     }else
                     {
                         isBorder = true;
-                        qBorder.push(PPUUU(PUU(nextRow , nextCol),neighbor));
+                        qBorder.push(FloodFillItem(row + Segmentation::neighborRow[neighbor],
+                                                   col + Segmentation::neighborCol[neighbor],
+                                                   neighbor));
                     }
                 }
             }
 
             // Close pixel acess
-            searchMask->at<uchar>(row,col) = 255;
+            *pMask = searchMask->closedStamp();
 
             // Register Element
-            seg->result.at<ushort>(0,seg->N) = row;
-            seg->result.at<ushort>(1,seg->N) = col;
-            seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-            seg->N++;
+            seg->addPixel(row,col,*pImg);
 
             #ifdef SEGEXTRAC_DRWING_DEBUG
             imshow("SegDebug", colorImg);
@@ -172,10 +160,7 @@ void OrderedBorderSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
                 #endif
 
                 // Register boarder element
-                seg->countor.at<ushort>(0,seg->NCountor) = row;
-                seg->countor.at<ushort>(1,seg->NCountor) = col;
-                seg->countor.at<ushort>(2,seg->NCountor) = img16bits.at<ushort>(row,col);
-                seg->NCountor++;
+                seg->addCountorPixel(row,col,*pImg);
 
                 // Take min max col and row
                 if(seg->MRow < row)
@@ -197,7 +182,7 @@ void OrderedBorderSegmentExtractor::load(ConfigLoader &config)
 
     if(config.getInt("General","MaxSampleSize",&vi))
     {
-        maxSampleSize = vi;
+        maxSampleSize = vi > 0 ? vi : Segment::NO_SIZE_LIMIT;
     }
 
     if(config.getInt("OrderedBorderSegmentExtractor","searchThreshold",&vi))
@@ -4,7 +4,8 @@
 #include <queue>
 using namespace std;
 
-PixelRelativeSegmentExtractor::PixelRelativeSegmentExtractor()
+PixelRelativeSegmentExtractor::PixelRelativeSegmentExtractor():
+    maxSampleSize(Segment::NO_SIZE_LIMIT)
 {
 }
 
@@ -20,19 +21,8 @@ PixelRelativeSegmentExtractor::PixelRelativeSegmentExtractor()
  */
 void PixelRelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsigned row, unsigned col)
 {
-    // Realocate memory if necsessary
-    if(seg->result.rows < 3 || seg->result.cols < maxSampleSize)
-    {
-        #ifdef SEGMENTATION_MEMORORY_DEBUG
-            cout << "createSegmentRelativePixelCount: Allocating memory for segments!!" << endl;
-        #endif
-        seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
-
     // Initialize segment
-    seg->N = 0;
-    seg->MCol = seg->MRow = 0;
-    seg->mRow = seg->mCol = 99999;
+    seg->clear();
 
     // Initialize queue of BFS
     typedef pair<unsigned, unsigned> PUU;
@@ -41,7 +31,7 @@ void PixelRelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
 
     // Add first element
     q.push(PUPUU(img16bits.at<ushort>(row,col),PUU(row,col)));
-    searchMask->at<uchar>(row,col) = 255;
+    searchMask->set(row,col,SEARCH_MASK_CLOSED);
 
     while(!q.empty() && seg->N < maxSampleSize)
     {
@@ -50,10 +40,7 @@ void PixelRelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
         q.pop();
 
         // Register element
-        seg->result.at<ushort>(0,seg->N) = row;
-        seg->result.at<ushort>(1,seg->N) = col;
-        seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-        seg->N++;
+        seg->addPixel(row,col,img16bits.at<ushort>(row,col));
 
         // Take min max col and row
         if(seg->MRow < row)
@@ -78,10 +65,10 @@ void PixelRelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, u
 
             // If neighbor wasn't visited
             if(img16bits.at<ushort>(nextRow , nextCol) >= 40 &&
-               searchMask->at<uchar>(nextRow,nextCol) != 255)
+               searchMask->get(nextRow,nextCol) != SEARCH_MASK_CLOSED)
             {
                 // Register the visit of pixel
-                searchMask->at<uchar>(nextRow,nextCol) = 255;
+                searchMask->set(nextRow,nextCol,SEARCH_MASK_CLOSED);
 
                 // Register new querry
                 q.push(PUPUU(img16bits.at<ushort>(nextRow , nextCol),
@@ -6,9 +6,9 @@
 using namespace std;
 
 
-RelativeSegmentExtractor::RelativeSegmentExtractor()
+RelativeSegmentExtractor::RelativeSegmentExtractor():
+    maxSampleSize(Segment::NO_SIZE_LIMIT)
 {
-
 }
 
 /**
@@ -29,19 +29,8 @@ void RelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsign
     }
     if(relativeThreshold < 50) relativeThreshold = 50;
 
-    // Realocate memory if necsessary
-    if(seg->result.rows < 3 && seg->result.cols < maxSampleSize)
-    {
-        #ifdef SEGMENTATION_MEMORORY_DEBUG
-            cout << "createSegmentRelative: Allocating memory for segments!!" << endl;
-        #endif
-        seg->result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
-
     // Initialize segment
-    seg->N = 0;
-    seg->MCol = seg->MRow = 0;
-    seg->mRow = seg->mCol = 99999;
+    seg->clear();
 
     // Initialize queue of BFS
     typedef pair<unsigned, unsigned> PUU;
@@ -49,13 +38,10 @@ void RelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsign
 
     // Add first element
     q.push(PUU(row,col));
-    searchMask->at<uchar>(row,col) = 255;
+    searchMask->set(row,col,SEARCH_MASK_CLOSED);
 
     // Register first element
-    seg->result.at<ushort>(0,seg->N) = row;
-    seg->result.at<ushort>(1,seg->N) = col;
-    seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-    seg->N++;
+    seg->addPixel(row,col,img16bits.at<ushort>(row,col));
 
     // Take min max col and row
     if(seg->MRow < row)
@@ -86,16 +72,13 @@ void RelativeSegmentExtractor::createSegment(Segment *seg, Mat img16bits, unsign
 
             // If neighbor wasn't visited
             if(img16bits.at<ushort>(nextRow , nextCol) >= relativeThreshold
-               && searchMask->at<uchar>(nextRow,nextCol) != 255)
+               && searchMask->get(nextRow,nextCol) != SEARCH_MASK_CLOSED)
             {
                 // Register the visit of pixel
-                searchMask->at<uchar>(nextRow,nextCol) = 255;
+                searchMask->set(nextRow,nextCol,SEARCH_MASK_CLOSED);
 
                 // Register pixel information
-                seg->result.at<ushort>(0,seg->N) = row;
-                seg->result.at<ushort>(1,seg->N) = col;
-                seg->result.at<ushort>(2,seg->N) = img16bits.at<ushort>(row,col);
-                seg->N++;
+                seg->addPixel(row,col,img16bits.at<ushort>(row,col));
 
                 // Take min max col and row
                 if(seg->MRow < row)
@@ -12,6 +12,7 @@
 using namespace cv;
 
 #include "Segment.h"
+#include "SearchMask.h"
 #include "Sonar/SonarConfig/ConfigLoader.h"
 
 class Segmentation;
@@ -19,7 +20,7 @@ class Segmentation;
 class SegmentExtractor
 {
 protected:
-    Mat *searchMask;
+    SearchMask *searchMask;
     Segmentation *m_seg;
 
 public:
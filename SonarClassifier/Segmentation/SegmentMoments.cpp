@@ -0,0 +1,85 @@
+#include "SegmentMoments.h"
+
+#include <cmath>
+
+void SegmentMoments::add(const SegmentMoments &m)
+{
+    n+= m.n;
+    sRow+= m.sRow;
+    sCol+= m.sCol;
+    sI+= m.sI;
+    sRowRow+= m.sRowRow;
+    sColCol+= m.sColCol;
+    sRowCol+= m.sRowCol;
+    sII+= m.sII;
+}
+
+double SegmentMoments::meanRow() const
+{
+    return n == 0 ? 0.0 : (double) sRow / n;
+}
+
+double SegmentMoments::meanCol() const
+{
+    return n == 0 ? 0.0 : (double) sCol / n;
+}
+
+double SegmentMoments::meanIntensity() const
+{
+    return n == 0 ? 0.0 : (double) sI / n;
+}
+
+/**
+ * @brief Intensity standard deviation (divided by n as meanStdDev).
+ */
+double SegmentMoments::stdIntensity() const
+{
+    if(n == 0) return 0.0;
+
+    double mean = meanIntensity(),
+           var = (double) sII / n - mean*mean;
+
+    return var > 0.0 ? sqrt(var) : 0.0;
+}
+
+/**
+ * @brief Covariance matrix of row and col, scaled by 1/n
+ * (as calcCovarMatrix with CV_COVAR_SCALE).
+ */
+void SegmentMoments::covariance(double *varRow, double *varCol, double *covRowCol) const
+{
+    if(n == 0)
+    {
+        *varRow = *varCol = *covRowCol = 0.0;
+        return;
+    }
+
+    double mRow = meanRow(), mCol = meanCol();
+
+    *varRow = (double) sRowRow / n - mRow*mRow;
+    *varCol = (double) sColCol / n - mCol*mCol;
+    *covRowCol = (double) sRowCol / n - mRow*mCol;
+}
+
+/**
+ * @brief Closed form eigen decomposition of the 2x2 covariance matrix.
+ *
+ * @param major - Greater eigenvalue (variance on the principal axis)
+ * @param minor - Smaller eigenvalue
+ * @param angRad - Angle of principal axis, the eigenvector is
+ * (row,col) = (cos(angRad), sin(angRad)), angRad in [-pi/2, pi/2]
+ */
+void SegmentMoments::principalAxes(double *major, double *minor, double *angRad) const
+{
+    double a, c, b;
+    covariance(&a, &c, &b);
+
+    double halfTrace = (a+c)/2.0,
+           r = sqrt((a-c)*(a-c)/4.0 + b*b);
+
+    *major = halfTrace + r;
+    *minor = halfTrace - r;
+    if(*minor < 0.0) *minor = 0.0; // Rounding on degenerated segments
+
+    *angRad = 0.5*atan2(2.0*b, a-c);
+}
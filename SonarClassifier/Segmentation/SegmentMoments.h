@@ -0,0 +1,52 @@
+#ifndef SEGMENTMOMENTS_H
+#define SEGMENTMOMENTS_H
+
+/**
+ * @brief Raw moments of a segment pixels (row, col and intensity)
+ * accumulated while the extractor registers each pixel
+ * (Segment::addPixel), so mean, covariance and principal axes
+ * are computed in O(1) after extraction.
+ *  Integer sums are exact, rows, cols and intensities are 16 bits.
+ */
+class SegmentMoments
+{
+public:
+    unsigned long long n,
+                       sRow, sCol, sI,          // First order sums
+                       sRowRow, sColCol, sRowCol, sII; // Second order sums
+
+    SegmentMoments()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        n = sRow = sCol = sI = 0;
+        sRowRow = sColCol = sRowCol = sII = 0;
+    }
+
+    void add(unsigned row, unsigned col, unsigned intensity)
+    {
+        n++;
+        sRow+= row;
+        sCol+= col;
+        sI+= intensity;
+        sRowRow+= (unsigned long long) row*row;
+        sColCol+= (unsigned long long) col*col;
+        sRowCol+= (unsigned long long) row*col;
+        sII+= (unsigned long long) intensity*intensity;
+    }
+
+    void add(const SegmentMoments &m);
+
+    double meanRow() const;
+    double meanCol() const;
+    double meanIntensity() const;
+    double stdIntensity() const;
+
+    void covariance(double *varRow, double *varCol, double *covRowCol) const;
+    void principalAxes(double *major, double *minor, double *angRad) const;
+};
+
+#endif // SEGMENTMOMENTS_H
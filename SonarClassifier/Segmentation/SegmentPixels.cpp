@@ -0,0 +1,87 @@
+#include "SegmentPixels.h"
+#include "Segmentation.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+SegmentPixels::SegmentPixels(SegmentArena *arena):
+    m_data(0x0), m_capacity(0),
+    m_arena(arena), m_epoch(0),
+    row(0x0), col(0x0), intensity(0x0)
+{
+}
+
+void SegmentPixels::setData(unsigned short *data, unsigned capacity)
+{
+    m_data = data;
+    m_capacity = capacity;
+
+    row = m_data;
+    col = m_data + capacity;
+    intensity = m_data + 2*capacity;
+}
+
+/**
+ * @brief Drop the storage if it's from an old arena epoch,
+ * it must be called before a segment is extracted again.
+ */
+void SegmentPixels::clear()
+{
+    if(m_arena != 0x0 && m_epoch != m_arena->epoch())
+        setData(0x0,0);
+}
+
+/**
+ * @brief Grow capacity to at least n pixels (doubling),
+ * the first keep pixels are copied.
+ */
+void SegmentPixels::reserve(unsigned n, unsigned keep)
+{
+    if(n <= m_capacity)
+        return;
+
+    unsigned capacity = std::max(std::max(n, 2*m_capacity), 256u);
+    unsigned short *data;
+
+    #ifdef SEGMENTATION_MEMORORY_DEBUG
+        cout << "SegmentPixels: Allocating " << capacity << " pixels!!" << endl;
+    #endif
+
+    vector<unsigned short> heap;
+    if(m_arena != 0x0)
+    {
+        data = m_arena->allocate(3*(size_t)capacity);
+        m_epoch = m_arena->epoch();
+    }else
+    {
+        heap.resize(3*(size_t)capacity);
+        data = &heap[0];
+    }
+
+    if(keep > 0)
+    {
+        memcpy(data, row, keep*sizeof(unsigned short));
+        memcpy(data+capacity, col, keep*sizeof(unsigned short));
+        memcpy(data+2*capacity, intensity, keep*sizeof(unsigned short));
+    }
+
+    if(m_arena == 0x0)
+        m_heap.swap(heap);
+
+    setData(data,capacity);
+}
+
+/**
+ * @brief Mat view (no copy) of count arrays, starting at
+ * array first (0 - row, 1 - col, 2 - intensity), of n pixels.
+ */
+Mat SegmentPixels::view(unsigned n, unsigned first, unsigned count) const
+{
+    if(m_data == 0x0)
+        return Mat(count, 0, CV_16UC1);
+
+    return Mat(count, n, CV_16UC1,
+               m_data + first*m_capacity,
+               m_capacity*sizeof(unsigned short));
+}
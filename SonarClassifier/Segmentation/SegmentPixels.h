@@ -0,0 +1,53 @@
+#ifndef SEGMENTPIXELS_H
+#define SEGMENTPIXELS_H
+
+#include <opencv2/core/core.hpp>
+#include <vector>
+
+#include "SegmentArena.h"
+
+using namespace std;
+using namespace cv;
+
+/**
+ * @brief Structure of arrays storage of segment pixels: row, col
+ * and intensity arrays, the pixel count is kept by Segment.
+ *
+ *  The three arrays are in one block with stride capacity(), so
+ * view() gives consecutive arrays as a CV_16UC1 Mat without copy
+ * (e.g. for calcCovarMatrix and meanStdDev).
+ *  Storage grows geometrically from the SegmentArena of Segmentation,
+ * or from the heap when there is no arena (segments on the stack).
+ */
+class SegmentPixels
+{
+    unsigned short *m_data;
+    unsigned m_capacity;
+
+    SegmentArena *m_arena;
+    unsigned m_epoch; // Arena epoch of m_data
+    vector<unsigned short> m_heap; // Storage when there is no arena
+
+    // Not copyable
+    SegmentPixels(const SegmentPixels &);
+    SegmentPixels &operator=(const SegmentPixels &);
+
+    void setData(unsigned short *data, unsigned capacity);
+
+public:
+    unsigned short *row, *col, *intensity;
+
+    SegmentPixels(SegmentArena *arena=0x0);
+
+    void clear();
+    void reserve(unsigned n, unsigned keep);
+
+    unsigned capacity() const
+    {
+        return m_capacity;
+    }
+
+    Mat view(unsigned n, unsigned first=0, unsigned count=3) const;
+};
+
+#endif // SEGMENTPIXELS_H
@@ -0,0 +1,135 @@
+#include "BeamLUT.h"
+
+#include <cmath>
+
+#include <boost/thread/mutex.hpp>
+
+// Tables are never released, there is one per sonar geometry
+static vector<BeamLUT*> s_luts;
+static boost::mutex s_lutsMtx;
+
+BeamLUT::BeamLUT(unsigned rows, unsigned cols,
+                 unsigned nBeams, unsigned startBin,
+                 float bearing, int sonVerticalPosition,
+                 AngleStep angleStep):
+    rows(rows), cols(cols),
+    nBeams(nBeams), startBin(startBin),
+    nBins(rows > startBin ? rows-startBin : 0),
+    bearing(bearing), sonVerticalPosition(sonVerticalPosition),
+    angleStep(angleStep)
+{
+    build();
+}
+
+bool BeamLUT::sameGeometry(unsigned rows, unsigned cols,
+                           unsigned nBeams, unsigned startBin,
+                           float bearing, int sonVerticalPosition,
+                           AngleStep angleStep) const
+{
+    return this->rows == rows && this->cols == cols &&
+           this->nBeams == nBeams && this->startBin == startBin &&
+           this->bearing == bearing &&
+           this->sonVerticalPosition == sonVerticalPosition &&
+           this->angleStep == angleStep;
+}
+
+/**
+ * @brief Compute the beams exactly as the searchers did before
+ * the table, angle accumulation and position accumulation
+ * are kept in float.
+ */
+void BeamLUT::build()
+{
+    pixel.assign(nBeams*nBins,0);
+    position.assign(nBeams*nBins,Point2f(0.f,0.f));
+    beamLength.assign(nBeams,0);
+    beamStart.resize(nBeams);
+    beamDir.resize(nBeams);
+
+    // Sonar position botton middle of the image
+    Point2f sonarPos(cols/2.f, (int)rows+sonVerticalPosition);
+
+    float beamRadIncrement, radBearing = bearing*M_PI/180.f,
+          currentRad = -radBearing/2.f;
+
+    float beamAng,
+          cAng = -bearing/2.f;
+
+    // Compute ang variation
+    if(nBeams>1)
+    {
+        beamRadIncrement = radBearing/(nBeams-1);
+        beamAng = bearing/(nBeams-1);
+    }else
+    {
+        beamRadIncrement = 2*radBearing; // Infinity!
+        beamAng = 2*bearing;
+    }
+
+    for(unsigned beam = 0; beam < nBeams; beam++, currentRad+=beamRadIncrement, cAng+=beamAng)
+    {
+        Point2f binPos, dir;
+
+        if(angleStep == RADIAN_STEP)
+        {
+            float sinRad = sin(currentRad),
+                  cosRad = cos(currentRad);
+
+            binPos = Point2f(sonarPos.x - startBin*sinRad,
+                             sonarPos.y - startBin*cosRad);
+            dir = Point2f(-sinRad,-cosRad);
+        }else
+        {
+            float radAng = cAng*M_PI/180.f;
+
+            binPos = Point2f(sonarPos.x - startBin*sin(radAng),
+                             sonarPos.y - startBin*cos(radAng));
+            dir = Point2f(-sin(radAng),-cos(radAng));
+        }
+
+        beamStart[beam] = binPos;
+        beamDir[beam] = dir;
+
+        int *px = &pixel[beam*nBins];
+        Point2f *pos = &position[beam*nBins];
+
+        unsigned bin;
+        for(bin = 0; bin < nBins; bin++)
+        {
+            binPos+= dir;
+
+            // Same truncation of Mat::at(float,float)
+            int row = binPos.y, col = binPos.x;
+            if(row < 0 || row >= (int)rows || col < 0 || col >= (int)cols)
+                break;
+
+            px[bin] = row*cols + col;
+            pos[bin] = binPos;
+        }
+        beamLength[beam] = bin;
+    }
+}
+
+/**
+ * @brief Return the table of a sonar geometry, it's
+ * created on the first call. It's thread safe.
+ */
+const BeamLUT *BeamLUT::get(unsigned rows, unsigned cols,
+                            unsigned nBeams, unsigned startBin,
+                            float bearing, int sonVerticalPosition,
+                            AngleStep angleStep)
+{
+    boost::mutex::scoped_lock lock(s_lutsMtx);
+
+    for(unsigned i = 0 ; i < s_luts.size(); i++)
+    {
+        if(s_luts[i]->sameGeometry(rows,cols,nBeams,startBin,
+                                   bearing,sonVerticalPosition,angleStep))
+            return s_luts[i];
+    }
+
+    BeamLUT *lut = new BeamLUT(rows,cols,nBeams,startBin,
+                               bearing,sonVerticalPosition,angleStep);
+    s_luts.push_back(lut);
+    return lut;
+}
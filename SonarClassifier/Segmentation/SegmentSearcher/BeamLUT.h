@@ -0,0 +1,71 @@
+#ifndef BEAMLUT_H
+#define BEAMLUT_H
+
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
+using namespace std;
+using namespace cv;
+
+/**
+ * @brief Polar to cartesian lookup table of the beams
+ * sampled by the ThetaRho segment searchers.
+ *  For each (beam, bin) it stores the linear pixel index
+ * (row*cols + col) and the float position, computed with the same
+ * float accumulation (pos+= beamDir) used by the searchers, so
+ * the sampled pixels and peak positions are exactly the same.
+ *  Tables are built once per geometry and shared by all searchers
+ * (and threads) through BeamLUT::get().
+ */
+class BeamLUT
+{
+public:
+    enum AngleStep
+    {
+        RADIAN_STEP, /**< Beam angle accumulated in radians (ThetaRhoMeanPeakSegSearch, ThetaRhoSortSegSearch) */
+        DEGREE_STEP  /**< Beam angle accumulated in degrees (ThetaRhoSegmentSearcher) */
+    };
+
+    unsigned rows, cols,
+             nBeams, startBin, nBins;
+    float bearing;
+    int sonVerticalPosition;
+    AngleStep angleStep;
+
+    vector<int> pixel;         /**< nBeams x nBins linear pixel index */
+    vector<Point2f> position;  /**< nBeams x nBins accumulated bin position */
+    vector<unsigned> beamLength; /**< Bins inside the image, a beam stops at its first bin outside the image */
+    vector<Point2f> beamStart, beamDir;
+
+private:
+    BeamLUT(unsigned rows, unsigned cols,
+            unsigned nBeams, unsigned startBin,
+            float bearing, int sonVerticalPosition,
+            AngleStep angleStep);
+
+    bool sameGeometry(unsigned rows, unsigned cols,
+                      unsigned nBeams, unsigned startBin,
+                      float bearing, int sonVerticalPosition,
+                      AngleStep angleStep) const;
+
+    void build();
+
+public:
+    static const BeamLUT *get(unsigned rows, unsigned cols,
+                              unsigned nBeams, unsigned startBin,
+                              float bearing, int sonVerticalPosition,
+                              AngleStep angleStep);
+
+    const int *beamPixels(unsigned beam) const
+    {
+        return pixel.empty() ? 0x0 : &pixel[beam*nBins];
+    }
+
+    const Point2f *beamPositions(unsigned beam) const
+    {
+        return position.empty() ? 0x0 : &position[beam*nBins];
+    }
+};
+
+#endif // BEAMLUT_H
@@ -0,0 +1,345 @@
+#include "BeamPeakDetector.h"
+
+#include <iostream>
+#include <cstdlib>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+#include "Cronometer.h"
+
+BeamPeakDetector::BeamPeakDetector(int Hmin, unsigned meanWindowSize):
+    Hmin(Hmin), meanWindowSize(meanWindowSize)
+{
+}
+
+void BeamPeakDetector::setParameters(int Hmin, unsigned meanWindowSize)
+{
+    this->Hmin = Hmin;
+    this->meanWindowSize = meanWindowSize;
+}
+
+/**
+ * @brief Search the first bin in [beg,end) that starts a peak,
+ * assuming that the mean window of each bin holds the
+ * meanWindowSize previous bins (beg >= meanWindowSize).
+ * @return end if there is no peak start.
+ */
+unsigned BeamPeakDetector::findPeakStart(const int *x, unsigned beg, unsigned end) const
+{
+    const int *P = &m_prefix[0];
+    const int W = meanWindowSize;
+    unsigned j = beg;
+
+#if defined(__AVX2__)
+    const __m256i vW = _mm256_set1_epi32(W),
+                  vH = _mm256_set1_epi32(Hmin);
+
+    for(; j+8 <= end; j+=8)
+    {
+        __m256i xi = _mm256_loadu_si256((const __m256i*)(x+j)),
+                acc = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(P+j)),
+                                       _mm256_loadu_si256((const __m256i*)(P+j-W))),
+                rhs = _mm256_mullo_epi32(_mm256_sub_epi32(xi,vH),vW);
+
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(rhs,acc)));
+        if(mask)
+            return j + __builtin_ctz(mask);
+    }
+#elif defined(__SSE4_1__)
+    const __m128i vW = _mm_set1_epi32(W),
+                  vH = _mm_set1_epi32(Hmin);
+
+    for(; j+4 <= end; j+=4)
+    {
+        __m128i xi = _mm_loadu_si128((const __m128i*)(x+j)),
+                acc = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(P+j)),
+                                    _mm_loadu_si128((const __m128i*)(P+j-W))),
+                rhs = _mm_mullo_epi32(_mm_sub_epi32(xi,vH),vW);
+
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(rhs,acc)));
+        if(mask)
+            return j + __builtin_ctz(mask);
+    }
+#endif
+
+    for(; j < end; j++)
+    {
+        if(P[j]-P[j-W] < (x[j]-Hmin)*W)
+            return j;
+    }
+    return end;
+}
+
+/**
+ * @brief Original bin by bin peak detection.
+ *
+ * @param x - Beam intensities.
+ * @param nBins - Beam length.
+ * @param peaks - Peaks found are appended here.
+ */
+void BeamPeakDetector::detectScalar(const int *x, unsigned nBins, vector<BeamPeak> &peaks)
+{
+    const unsigned W = meanWindowSize;
+    if(m_window.size() < W) m_window.resize(W);
+
+    unsigned wBeg=0, wSz=0;
+    int ACCIntensity = 0,
+        maxHeight = 0, maxHBin = -1,
+        minHeight = 99999;
+    bool onPeak=false; // True if we are on a intensity peak
+
+    for(unsigned bin = 0; bin < nBins; bin++)
+    {
+        int binI = x[bin],
+            meanIntensity=0,
+            peakHeight;
+
+        // Compute mean intensity
+        if(wSz > 0)
+            meanIntensity = ACCIntensity/(int)wSz;
+
+        // Compue peak height
+        peakHeight = binI - meanIntensity;
+
+        // Verity if this intensity is a peak
+        if(peakHeight > Hmin)
+        {
+            if(!onPeak)
+            {   // We are entering on a intensity peak
+                minHeight = maxHeight = peakHeight;
+                maxHBin = bin;
+                onPeak = true;
+            }else
+            {
+                if(peakHeight > maxHeight)
+                {
+                    maxHeight = peakHeight;
+                    maxHBin = bin;
+                }else if(peakHeight < minHeight)
+                {
+                    minHeight = peakHeight;
+                }
+            }
+        }else if(onPeak)
+        {// End of peak analisy
+            BeamPeak p;
+            p.threshold = meanIntensity+minHeight;
+            p.bin = maxHBin;
+            peaks.push_back(p);
+
+            onPeak = false;
+            maxHeight = 0;
+            maxHBin = -1;
+        }
+
+        if(!onPeak && W > 0)
+        {
+            // Save current bin
+            if(wSz >= W)
+            { // Remove older bin
+                ACCIntensity -= m_window[wBeg];
+                wBeg = (wBeg+1)%W;
+                wSz--;
+            }
+            // Add newer bin
+            ACCIntensity+= binI;
+            m_window[(wBeg+wSz)%W] = binI;
+            wSz++;
+        }
+    }
+}
+
+/**
+ * @brief Peak detection with vectorized search of peak starts,
+ * the result is identical to detectScalar().
+ */
+void BeamPeakDetector::detect(const int *x, unsigned nBins, vector<BeamPeak> &peaks)
+{
+    const unsigned W = meanWindowSize;
+
+    // Out of the exact range of the vectorized compare
+    if(W == 0 || W > 32767 || Hmin < 0 || nBins > 32767)
+    {
+        detectScalar(x,nBins,peaks);
+        return;
+    }
+
+    if(m_window.size() < W) m_window.resize(W);
+    if(m_prefix.size() < nBins+1) m_prefix.resize(nBins+1);
+
+    int *P = &m_prefix[0];
+    P[0] = 0;
+    for(unsigned i = 0 ; i < nBins; i++)
+        P[i+1] = P[i] + x[i];
+
+    unsigned wBeg=0, wSz=0,
+             run=0; // Consecutive bins saved on mean window
+    int ACCIntensity = 0,
+        maxHeight = 0, maxHBin = -1,
+        minHeight = 99999;
+    bool onPeak=false;
+
+    unsigned bin = 0;
+    while(bin < nBins)
+    {
+        if(!onPeak && run >= W)
+        {
+            // Mean window holds bins [bin-W, bin), skip to next peak start
+            unsigned next = findPeakStart(x,bin,nBins);
+            if(next > bin)
+            {
+                run+= next-bin;
+                bin = next;
+
+                wBeg = 0; wSz = W;
+                for(unsigned i = 0 ; i < W; i++)
+                    m_window[i] = x[bin-W+i];
+                ACCIntensity = P[bin] - P[bin-W];
+
+                if(bin >= nBins) break;
+            }
+        }
+
+        // Same step of detectScalar()
+        int binI = x[bin],
+            meanIntensity=0,
+            peakHeight;
+
+        if(wSz > 0)
+            meanIntensity = ACCIntensity/(int)wSz;
+
+        peakHeight = binI - meanIntensity;
+
+        if(peakHeight > Hmin)
+        {
+            if(!onPeak)
+            {
+                minHeight = maxHeight = peakHeight;
+                maxHBin = bin;
+                onPeak = true;
+            }else
+            {
+                if(peakHeight > maxHeight)
+                {
+                    maxHeight = peakHeight;
+                    maxHBin = bin;
+                }else if(peakHeight < minHeight)
+                {
+                    minHeight = peakHeight;
+                }
+            }
+        }else if(onPeak)
+        {
+            BeamPeak p;
+            p.threshold = meanIntensity+minHeight;
+            p.bin = maxHBin;
+            peaks.push_back(p);
+
+            onPeak = false;
+            maxHeight = 0;
+            maxHBin = -1;
+        }
+
+        if(!onPeak)
+        {
+            if(wSz >= W)
+            {
+                ACCIntensity -= m_window[wBeg];
+                wBeg = (wBeg+1)%W;
+                wSz--;
+            }
+            ACCIntensity+= binI;
+            m_window[(wBeg+wSz)%W] = binI;
+            wSz++;
+            run++;
+        }else run = 0;
+
+        bin++;
+    }
+}
+
+const char *BeamPeakDetector::simdName()
+{
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE4_1__)
+    return "SSE4.1";
+#else
+    return "none";
+#endif
+}
+
+/**
+ * @brief Microbenchmark of scalar and vectorized paths on
+ * random beams (dark noise background with a few high intensity blobs).
+ * The background must be darker than Hmin, the mean window starts
+ * empty (mean 0) as in the sonar images.
+ * @return true if both paths found the same peaks.
+ */
+bool BeamPeakDetector::benchmark(unsigned nBeams, unsigned nBins,
+                                 int Hmin, unsigned meanWindowSize,
+                                 unsigned repeat)
+{
+    vector<int> beams(nBeams*nBins);
+    srand(42);
+    for(unsigned b = 0 ; b < nBeams; b++)
+    {
+        int *x = &beams[b*nBins];
+        for(unsigned i = 0 ; i < nBins; i++)
+            x[i] = rand()%100;
+
+        // Objects
+        unsigned nObj = rand()%4;
+        for(unsigned o = 0 ; o < nObj; o++)
+        {
+            unsigned beg = rand()%nBins, len = 3 + rand()%25;
+            for(unsigned i = beg ; i < beg+len && i < nBins; i++)
+                x[i] = 250 + rand()%700;
+        }
+    }
+
+    BeamPeakDetector detector(Hmin,meanWindowSize);
+    vector<BeamPeak> scalarPeaks, vectorPeaks;
+    scalarPeaks.reserve(nBeams*8);
+    vectorPeaks.reserve(nBeams*8);
+
+    Cronometer cron;
+    double scalarTime, vectorTime;
+
+    cron.reset();
+    for(unsigned r = 0 ; r < repeat; r++)
+    {
+        scalarPeaks.clear();
+        for(unsigned b = 0 ; b < nBeams; b++)
+            detector.detectScalar(&beams[b*nBins],nBins,scalarPeaks);
+    }
+    scalarTime = cron.reset()/repeat;
+
+    for(unsigned r = 0 ; r < repeat; r++)
+    {
+        vectorPeaks.clear();
+        for(unsigned b = 0 ; b < nBeams; b++)
+            detector.detect(&beams[b*nBins],nBins,vectorPeaks);
+    }
+    vectorTime = cron.reset()/repeat;
+
+    bool equal = scalarPeaks.size() == vectorPeaks.size();
+    for(unsigned i = 0 ; equal && i < scalarPeaks.size(); i++)
+        equal = scalarPeaks[i].bin == vectorPeaks[i].bin &&
+                scalarPeaks[i].threshold == vectorPeaks[i].threshold;
+
+    cout << "BeamPeakDetector benchmark (" << nBeams << "x" << nBins
+         << " Hmin " << Hmin << " window " << meanWindowSize
+         << " SIMD " << simdName() << ")" << endl
+         << "  scalar " << scalarTime << " usec/frame, "
+         << "vector " << vectorTime << " usec/frame, "
+         << "speedup " << (vectorTime > 0.0 ? scalarTime/vectorTime : 0.0) << endl
+         << "  peaks " << scalarPeaks.size()
+         << (equal ? " identical" : " DIFFERENT!!") << endl;
+
+    return equal;
+}
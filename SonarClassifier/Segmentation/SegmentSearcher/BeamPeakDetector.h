@@ -0,0 +1,70 @@
+#ifndef BEAMPEAKDETECTOR_H
+#define BEAMPEAKDETECTOR_H
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * @brief Intensity peak found on a beam.
+ */
+struct BeamPeak
+{
+    int threshold;  /**< Mean intensity + minimum peak height */
+    unsigned bin;   /**< Bin with maximum peak height */
+};
+
+/**
+ * @brief Running mean peak detector of ThetaRhoMeanPeakSegSearch.
+ *  The mean is computed over the last meanWindowSize bins
+ * that were not on a peak, a bin is on a peak when its intensity
+ * is higher than mean + Hmin.
+ *
+ *  detectScalar() is the original bin by bin implementation.
+ * detect() gives identical results: while the window holds the last
+ * meanWindowSize bins (no peak inside it) the window sum comes from
+ * the beam prefix sum, so the next peak start is searched with
+ * SSE4.1/AVX2 compares over many bins at once,
+ *    acc < (I - Hmin)*meanWindowSize  <=>  I - acc/meanWindowSize > Hmin
+ * (integer division), and only peaks and the windows after them
+ * are processed bin by bin.
+ *  Buffers are kept between calls, so use one detector per thread.
+ */
+class BeamPeakDetector
+{
+    int Hmin;
+    unsigned meanWindowSize;
+
+    vector<int> m_prefix; // Beam prefix sum
+    vector<int> m_window; // Ring buffer of the mean window
+
+    unsigned findPeakStart(const int *x, unsigned beg, unsigned end) const;
+
+public:
+    BeamPeakDetector(int Hmin=110, unsigned meanWindowSize=5);
+
+    void setParameters(int Hmin, unsigned meanWindowSize);
+
+    void detectScalar(const int *x, unsigned nBins, vector<BeamPeak> &peaks);
+    void detect(const int *x, unsigned nBins, vector<BeamPeak> &peaks);
+
+    static const char *simdName();
+
+    static bool benchmark(unsigned nBeams=768, unsigned nBins=1200,
+                          int Hmin=132, unsigned meanWindowSize=100,
+                          unsigned repeat=20);
+};
+
+// ======= Test Section =========
+
+//#include "Segmentation/SegmentSearcher/BeamPeakDetector.h"
+
+//int main()
+//{
+//    // Compare scalar and vector paths on random beams
+//    BeamPeakDetector::benchmark(768,1200,132,100,50);
+//    BeamPeakDetector::benchmark(768,1200,132,5,50);
+//    return 0;
+//}
+
+#endif // BEAMPEAKDETECTOR_H
@@ -67,7 +67,7 @@ void DoubleSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
     {
         for(unsigned col = 0 ; col < img16bits.cols ; col+=colJump)
         {
-            if(searchMask->at<uchar>(row,col) == 0 &&
+            if(searchMask->get(row,col) == SEARCH_MASK_FREE &&
                img16bits.at<ushort>(row,col) >= firstRhoLinear)
             {
                 // Search the segment on image
@@ -95,7 +95,7 @@ void DoubleSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
     {
         for(unsigned col = 0 ; col < img16bits.cols ; col+=colJump)
         {
-            if(searchMask->at<uchar>(row,col) == 0 &&
+            if(searchMask->get(row,col) == SEARCH_MASK_FREE &&
                img16bits.at<ushort>(row,col) >= secondRhoLinear)
             {
                 // Search the segment on image
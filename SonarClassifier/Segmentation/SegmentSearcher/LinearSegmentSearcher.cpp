@@ -84,7 +84,7 @@ void LinearSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
         for(unsigned col = 0 ; col < img16bits.cols ; col+=colJump)
         {
             ushort p = img16bits.at<ushort>(row,col) ;
-            if(searchMask->at<uchar>(row,col) == 0 &&
+            if(searchMask->get(row,col) == SEARCH_MASK_FREE &&
                imgMask->at<uchar>(row,col) != 0 &&
                p >= rhoLinear)
             {
@@ -122,7 +122,9 @@ void LinearSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
          << "number of ROI found " << segCount << endl
          << endl;
     waitKey();
-    imshow("LinearSeg:ResultedSearchMask", *searchMask);
+    Mat maskImg;
+    searchMask->toMat(maskImg);
+    imshow("LinearSeg:ResultedSearchMask", maskImg);
     waitKey();
 
 #endif
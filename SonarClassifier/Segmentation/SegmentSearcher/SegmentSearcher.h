@@ -19,7 +19,7 @@ class Segmentation;
 class SegmentSearcher
 {
 protected:
-    Mat *searchMask; /**< Indicate extracted pixels, used by segment extraction process*/
+    SearchMask *searchMask; /**< Indicate extracted pixels, used by segment extraction process*/
     Mat *imgMask; /**< Indicate the pixels how will be process */
     Segmentation *m_seg;
     SegmentExtractor *m_extractor;
@@ -195,7 +195,7 @@ bool SegmentWithPeak::createPeakImg(Mat &img16bits)
         unsigned row = peaks[i].second.first,
                  col = peaks[i].second.second;
 
-        if(searchMask->at<uchar>(row,col) == 0)
+        if(searchMask->get(row,col) == SEARCH_MASK_FREE)
         {
             // Search the segment on image
             seg = m_seg->segment(segCount);
@@ -270,7 +270,7 @@ void SegmentWithPeak::segment(Mat &img16bits, vector<Segment *> *sg)
         unsigned row = peaks[i].second.first,
                  col = peaks[i].second.second;
 
-        if(searchMask->at<uchar>(row,col) == 0)
+        if(searchMask->get(row,col) == SEARCH_MASK_FREE)
         {
             // Search the segment on image
             seg = m_seg->segment(segCount);
@@ -4,6 +4,10 @@
 #include "Segmentation.h"
 
 #include "Drawing/Chart.h"
+#include "BeamLUT.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 /**
  * @brief ThetaRhoMeanPeakSegSearch::ThetaRhoMeanPeakSegSearch
@@ -53,142 +57,108 @@
 ThetaRhoMeanPeakSegSearch::ThetaRhoMeanPeakSegSearch():
     nBeams(720),startBin(20),Hmin(110),bearing(130.f),
     sonVerticalPosition(1),
-    minSampleSize(10), meanWindowSize(5)
+    minSampleSize(10), meanWindowSize(5),
+    vectorPeakDetection(true), peakThreads(1)
 {
 
 }
 
-void ThetaRhoMeanPeakSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
+/**
+ * @brief Detect the peaks of beams [beamBeg, beamEnd), it only
+ * reads the image, so shards can run concurrently.
+ */
+void ThetaRhoMeanPeakSegSearch::detectPeaks(const BeamLUT *lut, const ushort *imgData,
+                                            unsigned beamBeg, unsigned beamEnd,
+                                            MeanPeakShard *shard)
 {
-    unsigned nBins = img16bits.rows-startBin;
-
-    float beamRadIncrement, radBearing = bearing*M_PI/180.f,
-          currentRad = -radBearing/2.f;
-
-    // Compute ang variation
-    if(nBeams>1)
-        beamRadIncrement = radBearing/(nBeams-1);
-    else beamRadIncrement = 2*radBearing; // Infinity!
-
-#ifdef SEGMENTATION_DRWING_DEBUG
-//    Mat result(img16bits.rows, img16bits.cols, CV_8UC3, Scalar(0,0,0));
+    shard->detector.setParameters(Hmin,meanWindowSize);
+    shard->beamIntensity.resize(lut->nBins);
+    shard->thresholds.clear();
+    shard->positions.clear();
 
-    Mat result;
-    img16bits.convertTo(result,CV_8UC1);
-    cvtColor(result,result,CV_GRAY2BGR);
-#endif
-
-    // Sonar position botton middle of the image
-    Point2f sonarPos(img16bits.cols/2.f, img16bits.rows+sonVerticalPosition);
-
-    vector<pair<int , unsigned> > peaks;
-    vector<Point2f> peaksPostions;
-    peaks.reserve(3000);
-    peaksPostions.reserve(3000);
-
-    CircularQueue lastBins(meanWindowSize);
-
-    // Bin peak search
     // For each beam
-    for(unsigned beam = 0; beam < nBeams; beam++, currentRad+=beamRadIncrement)
+    for(unsigned beam = beamBeg; beam < beamEnd; beam++)
     {
-        float sinRad = sin(currentRad),
-              cosRad = cos(currentRad);
-
-        Point2f binPos(sonarPos.x - startBin*sinRad,
-                        sonarPos.y - startBin*cosRad),
-                binStartPos(binPos);
-
-        Point2f beamDir(-sinRad,-cosRad);
-
-        int ACCIntensity = 0,
-            maxHeight = 0, maxHBin = -1,
-            minHeight = 99999, minHBin=-1;
-        bool onPeak=false; // True if we are on a intensity peak
+        const int *beamPixels = lut->beamPixels(beam);
+        unsigned nBins = lut->beamLength[beam];
 
-        lastBins.clear();
+        const Point2f &binStartPos = lut->beamStart[beam],
+                      &beamDir = lut->beamDir[beam];
 
-        // For each bin
+        // Gather beam intensities
+        int *x = shard->beamIntensity.empty() ? 0x0 : &shard->beamIntensity[0];
         for(unsigned bin = 0; bin < nBins; bin++)
-        // Unsigned overflow!
-        {
-            binPos+= beamDir;
+            x[bin] = imgData[beamPixels[bin]];
 
-            // Get bin intensity
-            int binI = img16bits.at<ushort>(binPos.y,binPos.x),
-                meanIntensity=0,
-                peakHeight;
-
-            // Compute mean intensity
-            if(lastBins.size() > 0)
-                meanIntensity = ACCIntensity/lastBins.size();
+        vector<BeamPeak> &beamPeaks = shard->beamPeaks;
+        beamPeaks.clear();
+        if(vectorPeakDetection)
+            shard->detector.detect(x,nBins,beamPeaks);
+        else
+            shard->detector.detectScalar(x,nBins,beamPeaks);
 
-            // Compue peak height
-            peakHeight = binI - meanIntensity;
+        for(unsigned i = 0 ; i < beamPeaks.size(); i++)
+        {
+            // Compute the peak position on sonar XY image (take maxHeight in acount)
+            shard->thresholds.push_back(beamPeaks[i].threshold);
+            shard->positions.push_back(binStartPos + beamDir * (int)beamPeaks[i].bin);
+        }
+    }
+}
 
-            // Verity if this intensity is a peak
-            if(peakHeight > Hmin)
-            {
-                if(!onPeak)
-                {   // We are entering on a intensity peak
-                    minHeight = maxHeight = peakHeight;
-                    minHBin = maxHBin = bin;
-                    onPeak = true;
-                }else
-                {
-                    if(peakHeight > maxHeight)
-                    {
-                        maxHeight = peakHeight;
-                        maxHBin = bin;
-                    }else if(peakHeight < minHeight)
-                    {
-                        minHeight = peakHeight;
-                        minHBin = bin;
-                    }
-                }
-            }else if(onPeak)
-            {// End of peak analisy
+void ThetaRhoMeanPeakSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
+{
+    // Beam sampling uses linear pixel index
+    Mat contImg = img16bits.isContinuous() ? img16bits : img16bits.clone();
 
-                // Compute threshold (take minHeight in acount)
-                int threshold = meanIntensity+minHeight;
-//cout << "Meam " << meanIntensity << " th " << threshold << endl;
+    const BeamLUT *lut = BeamLUT::get(img16bits.rows, img16bits.cols,
+                                      nBeams, startBin,
+                                      bearing, sonVerticalPosition,
+                                      BeamLUT::RADIAN_STEP);
+    const ushort *imgData = contImg.ptr<ushort>(0);
 
-                // Compute the peak position on sonar XY image (take maxHeight in acount)
-                Point2f peakPosition(binStartPos + beamDir * maxHBin);
-//                cout << "px " << peakPosition.x
-//                     << " py " << peakPosition.y
-//                     << " bin " << maxHBin
-//                     << endl;
+#ifdef SEGMENTATION_DRWING_DEBUG
+//    Mat result(img16bits.rows, img16bits.cols, CV_8UC3, Scalar(0,0,0));
 
-                peaks.push_back(pair<int,unsigned>(threshold,peaksPostions.size()));
-                peaksPostions.push_back(peakPosition);
+    Mat result;
+    img16bits.convertTo(result,CV_8UC1);
+    cvtColor(result,result,CV_GRAY2BGR);
+#endif
 
-                onPeak = false;
+    // Bin peak search, beams are sharded among peak threads
+    unsigned nShards = peakThreads;
+    if(nShards == 0)
+        nShards = max(1u, boost::thread::hardware_concurrency());
+    nShards = max(1u, min(nShards, lut->nBeams));
 
-                maxHeight = 0;
-                maxHBin = -1;
-            }
+    if(shards.size() < nShards)
+        shards.resize(nShards);
 
-            if(!onPeak)
-            {
-                // Save current bin
-                if(lastBins.size() >= meanWindowSize)
-                { // Remove older bin
-                    ACCIntensity -= lastBins.front();
-                    lastBins.pop();
-                }
-                // Add newer bin
-                ACCIntensity+= binI;
-                lastBins.push(binI);
-            }
+    if(nShards == 1)
+    {
+        detectPeaks(lut,imgData,0,lut->nBeams,&shards[0]);
+    }else
+    {
+        boost::thread_group workers;
+        for(unsigned s = 0 ; s < nShards; s++)
+            workers.create_thread(boost::bind(&ThetaRhoMeanPeakSegSearch::detectPeaks,this,
+                                              lut,imgData,
+                                              lut->nBeams*s/nShards,
+                                              lut->nBeams*(s+1)/nShards,
+                                              &shards[s]));
+        workers.join_all();
+    }
 
-            // Debug stuffs
-            #ifdef SEGMENTATION_DRWING_DEBUG
-                // Mark on resulted img the position of visited pixel
-//                result.at<Vec3b>(binPos.y,binPos.x)[0] = Drawing::color[beam%Drawing::nColor].val[0];
-//                result.at<Vec3b>(binPos.y,binPos.x)[1] = Drawing::color[beam%Drawing::nColor].val[1];
-//                result.at<Vec3b>(binPos.y,binPos.x)[2] = Drawing::color[beam%Drawing::nColor].val[2];
-            #endif
+    // Merge shards in beam order, same peak order of a single thread
+    peaks.clear();
+    peaksPostions.clear();
+    for(unsigned s = 0 ; s < nShards; s++)
+    {
+        MeanPeakShard &shard = shards[s];
+        for(unsigned i = 0 ; i < shard.thresholds.size(); i++)
+        {
+            peaks.push_back(pair<int,unsigned>(shard.thresholds[i],peaksPostions.size()));
+            peaksPostions.push_back(shard.positions[i]);
         }
     }
 
@@ -284,6 +254,16 @@ void ThetaRhoMeanPeakSegSearch::load(ConfigLoader &config)
         meanWindowSize = vi;
     }
 
+    if(config.getInt("ThetaRhoMeanPeakSegSearch","vectorPeakDetection",&vi))
+    {
+        vectorPeakDetection = vi != 0;
+    }
+
+    if(config.getInt("ThetaRhoMeanPeakSegSearch","peakThreads",&vi))
+    {
+        peakThreads = vi;
+    }
+
 }
 
 void ThetaRhoMeanPeakSegSearch::calibUI(Mat &img16bits)
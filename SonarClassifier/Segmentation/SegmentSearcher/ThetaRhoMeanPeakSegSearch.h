@@ -3,12 +3,29 @@
 
 #include "SegmentSearcher.h"
 #include "Tools/CircularQueue.h"
+#include "BeamPeakDetector.h"
+
+class BeamLUT;
 
 /* ==== Debub section ===== */
 #define THETARHOMEANPEAKSEGSEARCH_DRWING_DEBUG
 //#define CALIB_THETARHOMEANPEAKSEGSEARCH_DRWING_DEBUG
 /* ==== END Debub section ===== */
 
+/**
+ * @brief Peak detection state of a range of beams,
+ * each peak thread works on its own shard.
+ */
+struct MeanPeakShard
+{
+    BeamPeakDetector detector;
+    vector<int> beamIntensity;
+    vector<BeamPeak> beamPeaks;
+
+    vector<int> thresholds;           /**< Peaks found on the shard beams, in beam order */
+    vector<Point2f> positions;
+};
+
 class ThetaRhoMeanPeakSegSearch : public SegmentSearcher
 {
 private:
@@ -22,6 +39,19 @@ private:
 
     float bearing;
 
+    bool vectorPeakDetection; /**< Use BeamPeakDetector::detect() instead of detectScalar() */
+    unsigned peakThreads; /**< Threads of peak detection, 0 means one per hardware thread */
+
+    vector<MeanPeakShard> shards;
+
+    // Peaks of the frame, buffers are kept between frames
+    vector<pair<int , unsigned> > peaks;
+    vector<Point2f> peaksPostions;
+
+    void detectPeaks(const BeamLUT *lut, const ushort *imgData,
+                     unsigned beamBeg, unsigned beamEnd,
+                     MeanPeakShard *shard);
+
 public:
     ThetaRhoMeanPeakSegSearch();
 
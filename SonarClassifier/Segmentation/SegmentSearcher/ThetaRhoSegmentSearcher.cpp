@@ -4,6 +4,7 @@
 #include "Segmentation.h"
 
 #include "Drawing/Chart.h"
+#include "BeamLUT.h"
 
 
 ThetaRhoSegmentSearcher::ThetaRhoSegmentSearcher():
@@ -260,13 +261,16 @@ void ThetaRhoSegmentSearcher::calibUI(Mat &img16bits)
 
 void ThetaRhoSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
 {
-    unsigned nBins = img16bits.rows-startBin;
-    float beamAng,
-          cAng = -bearing/2.f;
+    // Beam sampling uses linear pixel index
+    Mat contImg = img16bits.isContinuous() ? img16bits : img16bits.clone();
 
-    if(nBeams>1)
-        beamAng = bearing/(nBeams-1);
-    else beamAng = 2*bearing; // Infinity!
+    const BeamLUT *lut = BeamLUT::get(img16bits.rows, img16bits.cols,
+                                      nBeams, startBin,
+                                      bearing, sonVerticalPosition,
+                                      BeamLUT::DEGREE_STEP);
+    const ushort *imgData = contImg.ptr<ushort>(0);
+
+    unsigned nBins = lut->nBins;
 
 #ifdef SEGMENTATION_DRWING_DEBUG
     Mat result(img16bits.rows, img16bits.cols, CV_8UC3, Scalar(0,0,0));
@@ -276,8 +280,6 @@ void ThetaRhoSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
 //    cvtColor(result,result,CV_GRAY2BGR);
 #endif
 
-    Point2f sonarPos(img16bits.cols/2.f, img16bits.rows+sonVerticalPosition);
-
     unsigned beam=nBeams-1;
 
     /* Initialize Mask of Visit */
@@ -289,14 +291,13 @@ void ThetaRhoSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
     Segment *seg=0x0;
 
     // For each beam
-    for(unsigned i = 0; i < nBeams; i++, cAng+=beamAng)
+    for(unsigned i = 0; i < nBeams; i++)
     {
-        float radAng = cAng*M_PI/180.f;
+        const int *beamPixels = lut->beamPixels(i);
+        const Point2f *beamPositions = lut->beamPositions(i);
+        unsigned beamLength = lut->beamLength[i];
 
-        Point2f beamPos(sonarPos.x - startBin*sin(radAng),
-                        sonarPos.y - startBin*cos(radAng));
-
-        Point2f beamDir(-sin(radAng),-cos(radAng));
+        const Point2f &beamDir = lut->beamDir[i];
 
         unsigned minBinI=99999, maxBinI=0, minBinN, maxBinN,
                  binI,
@@ -304,13 +305,13 @@ void ThetaRhoSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
                  lastThreshold=99999;
 
         // For each bin
-        for(unsigned bin = nBins-1 ; bin < nBins; bin--)
-        // Unsigned overflow!
+        for(unsigned k = 0 ; k < beamLength; k++)
         {
-            beamPos+= beamDir;
+            unsigned bin = nBins - k - 1;
+            const Point2f &beamPos = beamPositions[k];
 
             // If pixel was visited
-            if(searchMask->at<uchar>(beamPos.y,beamPos.x) == 255)
+            if(searchMask->get(beamPos.y,beamPos.x) == SEARCH_MASK_CLOSED)
             {  // Forget all informations about peaks
                 minBinI = 99999;
                 maxBinI = 0;
@@ -318,7 +319,7 @@ void ThetaRhoSegmentSearcher::segment(Mat &img16bits, vector<Segment *> *sg)
             }// if not, work with its
 
             // Save pixel intensity
-            binI = img16bits.at<ushort>(beamPos.y,beamPos.x);
+            binI = imgData[beamPixels[k]];
 
 
             #ifdef SEGMENTATION_DRWING_DEBUG
@@ -4,57 +4,40 @@
 #include "Segmentation.h"
 
 #include "Drawing/Chart.h"
+#include "BeamLUT.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 ThetaRhoSortSegSearch::ThetaRhoSortSegSearch():
     nBeams(720),startBin(20),Hmin(110),bearing(130.f),
     PiEnd(0.6f), PiRecursive(0.98),sonVerticalPosition(1),
-    minSampleSize(10)
+    minSampleSize(10), peakThreads(1)
 {
 }
 
-void ThetaRhoSortSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
+/**
+ * @brief Detect the peaks of beams [beamBeg, beamEnd). Peak
+ * detection doesn't depend on the visit mask, it only reads
+ * the image, so shards can run concurrently.
+ */
+void ThetaRhoSortSegSearch::detectPeaks(const BeamLUT *lut, const ushort *imgData,
+                                        unsigned beamBeg, unsigned beamEnd,
+                                        SortPeakShard *shard)
 {
-    unsigned nBins = img16bits.rows-startBin;
-
-    float beamRadIncrement, radBearing = bearing*M_PI/180.f,
-          currentRad = -radBearing/2.f;
-
-    // Compute ang variation
-    if(nBeams>1)
-        beamRadIncrement = radBearing/(nBeams-1);
-    else beamRadIncrement = 2*radBearing; // Infinity!
-
-#ifdef SEGMENTATION_DRWING_DEBUG
-    Mat result(img16bits.rows, img16bits.cols, CV_8UC3, Scalar(0,0,0));
-
-//    Mat result;
-//    img16bits.convertTo(result,CV_8UC1);
-//    cvtColor(result,result,CV_GRAY2BGR);
-#endif
-
-    // Sonar position botton middle of the image
-    Point2f sonarPos(img16bits.cols/2.f, img16bits.rows+sonVerticalPosition);
-
-    unsigned beam=nBeams-1;
+    unsigned nBins = lut->nBins;
 
-    /* Initialize Mask of Visit */
-    m_seg->resetMask(img16bits.rows,img16bits.cols);
-    sg->clear();
-
-    /* Search for high intensity pixels */
-    unsigned segCount=0;
-    Segment *seg=0x0;
+    shard->thresholds.clear();
+    shard->positions.clear();
 
     // For each beam
-    for(unsigned i = 0; i < nBeams; i++, currentRad+=beamRadIncrement)
+    for(unsigned i = beamBeg; i < beamEnd; i++)
     {
-        float sinRad = sin(currentRad),
-              cosRad = cos(currentRad);
-
-        Point2f beamPos(sonarPos.x - startBin*sinRad,
-                        sonarPos.y - startBin*cosRad);
+        const int *beamPixels = lut->beamPixels(i);
+        const Point2f *beamPositions = lut->beamPositions(i);
+        unsigned beamLength = lut->beamLength[i];
 
-        Point2f beamDir(-sinRad,-cosRad);
+        const Point2f &beamDir = lut->beamDir[i];
 
         unsigned minBinI=99999, maxBinI=0, minBinN=0, maxBinN=0,
                  binI,
@@ -62,21 +45,13 @@ void ThetaRhoSortSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
                  lastThreshold=99999;
 
         // For each bin
-        for(unsigned bin = nBins-1 ; bin < nBins; bin--)
-        // Unsigned overflow!
+        for(unsigned k = 0 ; k < beamLength; k++)
         {
-            beamPos+= beamDir;
+            unsigned bin = nBins - k - 1;
+            const Point2f &beamPos = beamPositions[k];
 
             // Save pixel intensity
-            binI = img16bits.at<ushort>(beamPos.y,beamPos.x);
-
-            #ifdef SEGMENTATION_DRWING_DEBUG
-                // Mark on result img the position of visited pixel
-                result.at<Vec3b>(beamPos.y,beamPos.x)[0] = Drawing::color[beam%Drawing::nColor].val[0];
-                result.at<Vec3b>(beamPos.y,beamPos.x)[1] = Drawing::color[beam%Drawing::nColor].val[1];
-                result.at<Vec3b>(beamPos.y,beamPos.x)[2] = Drawing::color[beam%Drawing::nColor].val[2];
-            #endif
-
+            binI = imgData[beamPixels[k]];
 
             if(binI < minBinI)
             {
@@ -102,28 +77,9 @@ void ThetaRhoSortSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
 
                         // Compute the peak position on sonar XY image
                         float vecUnit = nBins - bin - maxBinN;
-                        Point2f peakPosition(beamPos - beamDir * vecUnit);
-
-                        // Search the segment on image
-                        seg = m_seg->segment(segCount);
-
-                        m_extractor->setThreshold(lastThreshold);
-                        m_extractor->createSegment(seg,img16bits,
-                                                   peakPosition.y,peakPosition.x);
-
-                        // If segment is greater tham minimum acceptable segment size
-                        if(seg->N >= minSampleSize)
-                        {
-                            segCount++;
-
-                            #ifdef SEGMENTATION_DRWING_DEBUG
-                                seg->drawSegment(result,Drawing::color[segCount%Drawing::nColor]);
-                            #endif
-
-                            // Add seg to answer
-                            sg->push_back(seg);
-                        }
 
+                        shard->thresholds.push_back(lastThreshold);
+                        shard->positions.push_back(beamPos - beamDir * vecUnit);
                     }
 
                     // Reset Peak
@@ -133,13 +89,103 @@ void ThetaRhoSortSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
 
                 }
             }
-//            else
-//            {
-//                cout << "Caiu nesse caso!" << endl;
-//            }
         }
+    }
+}
+
+void ThetaRhoSortSegSearch::segment(Mat &img16bits, vector<Segment *> *sg)
+{
+    // Beam sampling uses linear pixel index
+    Mat contImg = img16bits.isContinuous() ? img16bits : img16bits.clone();
+
+    const BeamLUT *lut = BeamLUT::get(img16bits.rows, img16bits.cols,
+                                      nBeams, startBin,
+                                      bearing, sonVerticalPosition,
+                                      BeamLUT::RADIAN_STEP);
+    const ushort *imgData = contImg.ptr<ushort>(0);
+
+#ifdef SEGMENTATION_DRWING_DEBUG
+    Mat result(img16bits.rows, img16bits.cols, CV_8UC3, Scalar(0,0,0));
+
+//    Mat result;
+//    img16bits.convertTo(result,CV_8UC1);
+//    cvtColor(result,result,CV_GRAY2BGR);
+
+    // Mark on result img the position of visited pixels
+    for(unsigned i = 0; i < lut->nBeams; i++)
+    {
+        unsigned beam = lut->nBeams - i - 1;
+        const Point2f *beamPositions = lut->beamPositions(i);
+        for(unsigned k = 0 ; k < lut->beamLength[i]; k++)
+        {
+            const Point2f &beamPos = beamPositions[k];
+            result.at<Vec3b>(beamPos.y,beamPos.x)[0] = Drawing::color[beam%Drawing::nColor].val[0];
+            result.at<Vec3b>(beamPos.y,beamPos.x)[1] = Drawing::color[beam%Drawing::nColor].val[1];
+            result.at<Vec3b>(beamPos.y,beamPos.x)[2] = Drawing::color[beam%Drawing::nColor].val[2];
+        }
+    }
+#endif
+
+    // Bin peak search, beams are sharded among peak threads
+    unsigned nShards = peakThreads;
+    if(nShards == 0)
+        nShards = max(1u, boost::thread::hardware_concurrency());
+    nShards = max(1u, min(nShards, lut->nBeams));
+
+    if(shards.size() < nShards)
+        shards.resize(nShards);
+
+    if(nShards == 1)
+    {
+        detectPeaks(lut,imgData,0,lut->nBeams,&shards[0]);
+    }else
+    {
+        boost::thread_group workers;
+        for(unsigned s = 0 ; s < nShards; s++)
+            workers.create_thread(boost::bind(&ThetaRhoSortSegSearch::detectPeaks,this,
+                                              lut,imgData,
+                                              lut->nBeams*s/nShards,
+                                              lut->nBeams*(s+1)/nShards,
+                                              &shards[s]));
+        workers.join_all();
+    }
+
+    /* Initialize Mask of Visit */
+    m_seg->resetMask(img16bits.rows,img16bits.cols);
+    sg->clear();
+
+    /* Search for high intensity pixels */
+    unsigned segCount=0;
+    Segment *seg=0x0;
+
+    // Segments are extracted in beam and bin order, as peaks are found
+    for(unsigned s = 0 ; s < nShards; s++)
+    {
+        SortPeakShard &shard = shards[s];
+        for(unsigned i = 0 ; i < shard.thresholds.size(); i++)
+        {
+            Point2f &peakPosition = shard.positions[i];
 
-        beam--;
+            // Search the segment on image
+            seg = m_seg->segment(segCount);
+
+            m_extractor->setThreshold(shard.thresholds[i]);
+            m_extractor->createSegment(seg,img16bits,
+                                       peakPosition.y,peakPosition.x);
+
+            // If segment is greater tham minimum acceptable segment size
+            if(seg->N >= minSampleSize)
+            {
+                segCount++;
+
+                #ifdef SEGMENTATION_DRWING_DEBUG
+                    seg->drawSegment(result,Drawing::color[segCount%Drawing::nColor]);
+                #endif
+
+                // Add seg to answer
+                sg->push_back(seg);
+            }
+        }
     }
 
     #ifdef SEGMENTATION_DRWING_DEBUG
@@ -196,6 +242,11 @@ void ThetaRhoSortSegSearch::load(ConfigLoader &config)
     {
         PiRecursive = vf;
     }
+
+    if(config.getInt("ThetaRhoSegmentSearcher","peakThreads",&vi))
+    {
+        peakThreads = vi;
+    }
 }
 
 void ThetaRhoSortSegSearch::calibUI(Mat &img16bits)
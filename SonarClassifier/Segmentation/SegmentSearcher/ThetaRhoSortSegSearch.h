@@ -5,9 +5,20 @@
 #include "Sonar/SonarConfig/ConfigLoader.h"
 
 // ==== DEBUG SECTION ====
-#define SEGMENTATION_DRWING_DEBUG
+//#define SEGMENTATION_DRWING_DEBUG
 // ==== END DEBUG SECTION ====
 
+class BeamLUT;
+
+/**
+ * @brief Peaks found on a range of beams, in beam and bin order.
+ */
+struct SortPeakShard
+{
+    vector<unsigned> thresholds;
+    vector<Point2f> positions;
+};
+
 class ThetaRhoSortSegSearch : public SegmentSearcher
 {
 private:
@@ -22,6 +33,13 @@ private:
           PiEnd, /**< If a peak down low tham resetTax of height, reset a peak. */
           PiRecursive;  /**< Height percent of acceptable peak used for threshold */
 
+    unsigned peakThreads; /**< Threads of peak detection, 0 means one per hardware thread */
+    vector<SortPeakShard> shards;
+
+    void detectPeaks(const BeamLUT *lut, const ushort *imgData,
+                     unsigned beamBeg, unsigned beamEnd,
+                     SortPeakShard *shard);
+
 public:
     ThetaRhoSortSegSearch();
 
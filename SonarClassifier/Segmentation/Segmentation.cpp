@@ -123,15 +123,21 @@ Segment *Segmentation::segment(unsigned id)
 
     for(segSize ; segSize < segments.size() ; segSize++)
     {
-        segments[segSize] = new Segment;
+        segments[segSize] = new Segment(&segmentArena);
     }
 
     return segments[id];
 }
 
+/**
+ * @brief Clear the search mask, it's O(1) (new epoch of SearchMask)
+ * unless the image size changed. Pixels of the pooled segments are
+ * freed too (new epoch of SegmentArena).
+ */
 void Segmentation::resetMask(unsigned rows, unsigned cols)
 {
-    searchMask = Mat(rows, cols, CV_8UC1,Scalar(0));
+    searchMask.reset(rows,cols);
+    segmentArena.reset();
 #ifdef SEGMENTATION_SEARCH_DEBUG
     imgDebug.release();
 #endif
@@ -356,7 +362,7 @@ void Segmentation::createSegmentImg(Mat &img16bits)
     {
         for(unsigned col = 0 ; col < img16bits.cols ; col+=colJump)
         {
-            if(searchMask.at<uchar>(row,col) == 0 &&
+            if(searchMask.get(row,col) == SEARCH_MASK_FREE &&
                img16bits.at<ushort>(row,col) >= pixelThreshold)
             {
                 // Search the segment on image
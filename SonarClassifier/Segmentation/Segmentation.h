@@ -18,6 +18,9 @@
 #include "Segment.h"
 #include "SegmentSearcher/SegmentSearcher.h"
 #include "SegmentExtractor/SegmentExtractor.h"
+#include "FloodFillQueue.h"
+#include "SearchMask.h"
+#include "SegmentArena.h"
 
 using namespace std;
 using namespace cv;
@@ -40,12 +43,15 @@ public:
     unsigned maxSampleSize;
     int searchDistance;
 
-    Mat searchMask; // Used by floodfill search
+    SearchMask searchMask; // Used by floodfill search
     Mat imgMask;
 
+    FloodFillQueue floodQueue[2]; // Flood fill buffers shared by the extractors
+
     SegmentSearcher *m_segSearcher;
     SegmentExtractor *m_segExtractor;
 
+    SegmentArena segmentArena; // Pixels of segments, freed at each resetMask
     vector<Segment*> segments;
 
     static const int neighborRow[8];
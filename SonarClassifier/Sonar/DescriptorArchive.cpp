@@ -0,0 +1,394 @@
+#include "DescriptorArchive.h"
+
+#include <iostream>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// ====== DescriptorArchiveWriter =======
+
+bool DescriptorArchiveWriter::write(const void *data, size_t size)
+{
+    if(size == 0) return true;
+    if(fwrite(data,1,size,f) != size)
+    {
+        cout << "DescriptorArchiveWriter: Write error!" << endl;
+        return false;
+    }
+    pos+= size;
+    return true;
+}
+
+bool DescriptorArchiveWriter::align()
+{
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    return write(zeros, (8 - pos%8)%8);
+}
+
+DescriptorArchiveWriter::DescriptorArchiveWriter():
+    f(0x0), pos(0)
+{
+}
+
+DescriptorArchiveWriter::~DescriptorArchiveWriter()
+{
+    if(f != 0x0)
+        close();
+}
+
+bool DescriptorArchiveWriter::open(const char *fileName)
+{
+    if(f != 0x0)
+        close();
+
+    f = fopen(fileName, "wb");
+    if(f == 0x0)
+    {
+        cout << "DescriptorArchiveWriter: It was not possible to open file " << fileName << endl;
+        return false;
+    }
+
+    pos = 0;
+    index.clear();
+    names.clear();
+
+    // Header is rewritten on close
+    DAHeader header;
+    memset(&header,0,sizeof(header));
+    return write(&header,sizeof(header));
+}
+
+bool DescriptorArchiveWriter::addFrame(const SonarDescritor *sd, const string &fileName, unsigned frameNumber)
+{
+    if(f == 0x0)
+    {
+        cout << "DescriptorArchiveWriter: Archive not opened!" << endl;
+        return false;
+    }
+
+    if(!align()) return false;
+
+    DAFrameIndex fi;
+    memset(&fi,0,sizeof(fi));
+    fi.offset = pos;
+    fi.frameNumber = frameNumber;
+    fi.nameOffset = names.size();
+    fi.nameLength = fileName.size();
+    names+= fileName;
+
+    if(sd == 0x0)
+    {
+        fi.flags = DA_FRAME_EMPTY;
+        index.push_back(fi);
+        return true;
+    }
+
+    const vector<Gaussian> &gs = sd->gaussians;
+    const vector<vector<GraphLink*> > &graph = sd->graph;
+
+    fi.nGaussians = gs.size();
+
+    // Fixed size vertex records
+    vector<DAGaussian> rg(gs.size());
+    for(unsigned i = 0 ; i < gs.size(); i++)
+    {
+        const Gaussian &g = gs[i];
+        DAGaussian &r = rg[i];
+        memset(&r,0,sizeof(r));
+        r.x = g.x; r.y = g.y; r.intensity = g.intensity;
+        r.dx = g.dx; r.dy = g.dy; r.di = g.di; r.ang = g.ang;
+        r.N = g.N;
+        memcpy(r.hu,g.hu,sizeof(r.hu));
+        r.area = g.area;
+        r.perimeter = g.perimeter;
+        r.convexHullArea = g.convexHullArea;
+    }
+
+    // CSR edges, vertex without graph entry have no edges
+    vector<unsigned> edgeBegin(gs.size()+1,0);
+    vector<DAEdge> re;
+    for(unsigned i = 0 ; i < gs.size(); i++)
+    {
+        if(i < graph.size())
+        {
+            for(unsigned j = 0 ; j < graph[i].size(); j++)
+            {
+                const GraphLink *l = graph[i][j];
+                DAEdge e;
+                e.ang = l->ang; e.p = l->p;
+                e.rAng = l->rAng; e.invAngle = l->invAngle;
+                e.dest = l->dest;
+                re.push_back(e);
+            }
+        }
+        edgeBegin[i+1] = re.size();
+    }
+    fi.nEdges = re.size();
+
+    if(!write(rg.empty() ? 0x0 : &rg[0], rg.size()*sizeof(DAGaussian)) ||
+       !write(&edgeBegin[0], edgeBegin.size()*sizeof(unsigned)) ||
+       !write(re.empty() ? 0x0 : &re[0], re.size()*sizeof(DAEdge)))
+        return false;
+
+    index.push_back(fi);
+    return true;
+}
+
+bool DescriptorArchiveWriter::close()
+{
+    if(f == 0x0) return false;
+
+    DAHeader header;
+    memset(&header,0,sizeof(header));
+    memcpy(header.magic,DA_MAGIC,4);
+    header.version = DA_VERSION;
+    header.nFrames = index.size();
+    header.gaussianSize = sizeof(DAGaussian);
+    header.edgeSize = sizeof(DAEdge);
+
+    bool ok = align();
+    header.indexOffset = pos;
+    ok = ok && write(index.empty() ? 0x0 : &index[0], index.size()*sizeof(DAFrameIndex));
+    header.namesOffset = pos;
+    ok = ok && write(names.data(), names.size());
+
+    ok = ok && fseek(f,0,SEEK_SET) == 0 &&
+         fwrite(&header,sizeof(header),1,f) == 1;
+
+    if(fclose(f) != 0) ok = false;
+    f = 0x0;
+
+    if(!ok)
+        cout << "DescriptorArchiveWriter: Archive wasn't closed correctly!" << endl;
+
+    return ok;
+}
+
+// ====== DescriptorArchive =======
+
+DescriptorArchive::DescriptorArchive():
+    fd(-1), data(0x0), size(0),
+    header(0x0), index(0x0), names(0x0)
+{
+}
+
+DescriptorArchive::~DescriptorArchive()
+{
+    close();
+}
+
+bool DescriptorArchive::open(const char *fileName)
+{
+    close();
+
+    fd = ::open(fileName, O_RDONLY);
+    if(fd < 0)
+    {
+        cout << "DescriptorArchive: File " << fileName << " not found" << endl;
+        return false;
+    }
+
+    struct stat st;
+    if(fstat(fd,&st) != 0 || (size_t) st.st_size < sizeof(DAHeader))
+    {
+        cout << "DescriptorArchive: Invalid file " << fileName << endl;
+        close();
+        return false;
+    }
+    size = st.st_size;
+
+    void *p = mmap(0x0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(p == MAP_FAILED)
+    {
+        cout << "DescriptorArchive: mmap failed on file " << fileName << endl;
+        data = 0x0;
+        close();
+        return false;
+    }
+    data = (const char*) p;
+    header = (const DAHeader*) data;
+
+    if(memcmp(header->magic,DA_MAGIC,4) != 0 ||
+       header->version != DA_VERSION ||
+       header->gaussianSize != sizeof(DAGaussian) ||
+       header->edgeSize != sizeof(DAEdge) ||
+       header->indexOffset + header->nFrames*sizeof(DAFrameIndex) > size ||
+       header->namesOffset > size)
+    {
+        cout << "DescriptorArchive: Invalid or incompatible archive " << fileName << endl;
+        close();
+        return false;
+    }
+
+    index = (const DAFrameIndex*) (data + header->indexOffset);
+    names = data + header->namesOffset;
+
+    // Check frames bounds, so the accessors don't need it
+    for(unsigned i = 0 ; i < header->nFrames ; i++)
+    {
+        const DAFrameIndex &fi = index[i];
+        unsigned long long end = fi.offset +
+                fi.nGaussians*sizeof(DAGaussian) +
+                (fi.nGaussians+1)*sizeof(unsigned) +
+                fi.nEdges*sizeof(DAEdge);
+
+        if(fi.offset%8 != 0 || end > header->indexOffset ||
+           header->namesOffset + fi.nameOffset + fi.nameLength > size)
+        {
+            cout << "DescriptorArchive: Corrupted frame " << i
+                 << " on archive " << fileName << endl;
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void DescriptorArchive::close()
+{
+    if(data != 0x0)
+        munmap((void*) data, size);
+    if(fd >= 0)
+        ::close(fd);
+
+    fd = -1;
+    data = 0x0;
+    size = 0;
+    header = 0x0;
+    index = 0x0;
+    names = 0x0;
+}
+
+bool DescriptorArchive::isOpen() const
+{
+    return header != 0x0;
+}
+
+unsigned DescriptorArchive::numberOfFrames() const
+{
+    return header != 0x0 ? header->nFrames : 0;
+}
+
+unsigned DescriptorArchive::frameNumber(unsigned frame) const
+{
+    return index[frame].frameNumber;
+}
+
+string DescriptorArchive::frameFileName(unsigned frame) const
+{
+    return string(names + index[frame].nameOffset, index[frame].nameLength);
+}
+
+bool DescriptorArchive::isEmpty(unsigned frame) const
+{
+    return index[frame].flags & DA_FRAME_EMPTY;
+}
+
+unsigned DescriptorArchive::numberOfGaussians(unsigned frame) const
+{
+    return index[frame].nGaussians;
+}
+
+unsigned DescriptorArchive::numberOfEdges(unsigned frame) const
+{
+    return index[frame].nEdges;
+}
+
+const DAGaussian *DescriptorArchive::gaussians(unsigned frame) const
+{
+    return (const DAGaussian*) (data + index[frame].offset);
+}
+
+const unsigned *DescriptorArchive::edgeBegin(unsigned frame) const
+{
+    return (const unsigned*) (gaussians(frame) + index[frame].nGaussians);
+}
+
+const DAEdge *DescriptorArchive::edges(unsigned frame) const
+{
+    return (const DAEdge*) (edgeBegin(frame) + index[frame].nGaussians + 1);
+}
+
+/**
+ * @brief Decode a frame in a new SonarDescritor.
+ * @return 0x0 if the frame is empty.
+ */
+SonarDescritor *DescriptorArchive::loadFrame(unsigned frame) const
+{
+    if(frame >= numberOfFrames() || isEmpty(frame))
+        return 0x0;
+
+    SonarDescritor *sd = new SonarDescritor;
+    loadFrame(frame,sd);
+    return sd;
+}
+
+bool DescriptorArchive::loadFrame(unsigned frame, SonarDescritor *sd) const
+{
+    if(frame >= numberOfFrames())
+    {
+        cout << "DescriptorArchive: Invalid frame " << frame << endl;
+        return false;
+    }
+
+    sd->clearGraph();
+    sd->clearGaussian();
+
+    if(isEmpty(frame)) return true;
+
+    unsigned nG = numberOfGaussians(frame);
+    const DAGaussian *rg = gaussians(frame);
+    const unsigned *eb = edgeBegin(frame);
+    const DAEdge *re = edges(frame);
+
+    // Validate all edges before decoding, so sd
+    // is left empty on a corrupted frame
+    bool valid = eb[0] == 0 && eb[nG] == numberOfEdges(frame);
+    for(unsigned i = 0 ; i < nG && valid ; i++)
+        valid = eb[i] <= eb[i+1];
+    for(unsigned e = 0 ; e < eb[nG] && valid ; e++)
+        valid = re[e].dest >= 0 && (unsigned) re[e].dest < nG;
+
+    if(!valid)
+    {
+        cout << "DescriptorArchive: Corrupted edges on frame " << frame << endl;
+        sd->clearGraph();
+        sd->clearGaussian();
+        return false;
+    }
+
+    sd->gaussians.resize(nG);
+    sd->resizeGraph(nG);
+    sd->links.resize(eb[nG]);
+
+    for(unsigned i = 0 ; i < nG ; i++)
+    {
+        const DAGaussian &r = rg[i];
+        Gaussian &g = sd->gaussians[i];
+        g.x = r.x; g.y = r.y; g.intensity = r.intensity;
+        g.dx = r.dx; g.dy = r.dy; g.di = r.di; g.ang = r.ang;
+        g.N = r.N;
+        memcpy(g.hu,r.hu,sizeof(g.hu));
+        g.area = r.area;
+        g.perimeter = r.perimeter;
+        g.convexHullArea = r.convexHullArea;
+
+        vector<GraphLink*> &v = sd->graph[i];
+        v.reserve(eb[i+1]-eb[i]);
+        for(unsigned e = eb[i] ; e < eb[i+1] ; e++)
+        {
+            sd->links[e] = GraphLink(re[e].ang, re[e].rAng, re[e].invAngle,
+                                     re[e].p, re[e].dest);
+            v.push_back(&sd->links[e]);
+        }
+    }
+
+    sd->updateVertices();
+    sd->edges.build(sd->graph);
+
+    return true;
+}
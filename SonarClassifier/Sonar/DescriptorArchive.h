@@ -0,0 +1,149 @@
+#ifndef DESCRIPTORARCHIVE_H
+#define DESCRIPTORARCHIVE_H
+
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include "Sonar/SonarDescritor.h"
+
+using namespace std;
+
+/*
+ *  Binary descriptor archive layout (native endianness):
+ *
+ *  DAHeader
+ *  For each frame, 8 bytes aligned:
+ *      DAGaussian[nGaussians]
+ *      unsigned edgeBegin[nGaussians+1]   (CSR offsets)
+ *      DAEdge[nEdges]
+ *  DAFrameIndex[nFrames]
+ *  char names[]                           (frame file names)
+ */
+
+#define DA_MAGIC "SDAR"
+#define DA_VERSION 1u
+
+#define DA_FRAME_EMPTY 0x1u /**< Frame was not described (null descriptor) */
+
+struct DAHeader
+{
+    char magic[4];
+    unsigned version;
+    unsigned nFrames;
+    unsigned gaussianSize; /**< sizeof(DAGaussian) used on writing */
+    unsigned edgeSize;     /**< sizeof(DAEdge) used on writing */
+    unsigned reserved;
+    unsigned long long indexOffset;
+    unsigned long long namesOffset;
+};
+
+struct DAGaussian
+{
+    float x, y, intensity,
+          dx, dy, di, ang;
+    unsigned N;
+    double hu[7];
+    double area, perimeter, convexHullArea;
+};
+
+struct DAEdge
+{
+    float ang, p, rAng, invAngle;
+    int dest;
+};
+
+struct DAFrameIndex
+{
+    unsigned long long offset;
+    unsigned nGaussians;
+    unsigned nEdges;
+    unsigned frameNumber;
+    unsigned flags;
+    unsigned nameOffset;
+    unsigned nameLength;
+};
+
+/**
+ * @brief Write sonar descriptors on a binary archive,
+ * frames are appended one by one and the frame index
+ * is written on close().
+ */
+class DescriptorArchiveWriter
+{
+    FILE *f;
+    unsigned long long pos;
+    vector<DAFrameIndex> index;
+    string names;
+
+    bool write(const void *data, size_t size);
+    bool align();
+
+public:
+    DescriptorArchiveWriter();
+    ~DescriptorArchiveWriter();
+
+    bool open(const char *fileName);
+    bool addFrame(const SonarDescritor *sd, const string &fileName, unsigned frameNumber);
+    bool close();
+};
+
+/**
+ * @brief Read only memory mapped descriptor archive.
+ *  Opening only validates the header and the frame index,
+ * the descriptors are decoded when a frame is requested.
+ */
+class DescriptorArchive
+{
+    int fd;
+    const char *data;
+    size_t size;
+
+    const DAHeader *header;
+    const DAFrameIndex *index;
+    const char *names;
+
+public:
+    DescriptorArchive();
+    ~DescriptorArchive();
+
+    bool open(const char *fileName);
+    void close();
+    bool isOpen() const;
+
+    unsigned numberOfFrames() const;
+    unsigned frameNumber(unsigned frame) const;
+    string frameFileName(unsigned frame) const;
+    bool isEmpty(unsigned frame) const;
+
+    unsigned numberOfGaussians(unsigned frame) const;
+    unsigned numberOfEdges(unsigned frame) const;
+
+    // Raw access to mapped records
+    const DAGaussian *gaussians(unsigned frame) const;
+    const unsigned *edgeBegin(unsigned frame) const;
+    const DAEdge *edges(unsigned frame) const;
+
+    SonarDescritor *loadFrame(unsigned frame) const;
+    bool loadFrame(unsigned frame, SonarDescritor *sd) const;
+};
+
+/*
+// Some tests
+#include "Sonar/DescriptorArchive.h"
+
+int main(int argc, char* argv[])
+{
+    DescriptorArchive da;
+    if(!da.open("Descriptors.sda")) return 1;
+
+    for(unsigned i = 0 ; i < da.numberOfFrames(); i++)
+        cout << da.frameFileName(i) << " "
+             << da.numberOfGaussians(i) << " "
+             << da.numberOfEdges(i) << endl;
+
+    return 0;
+}
+*/
+
+#endif // DESCRIPTORARCHIVE_H
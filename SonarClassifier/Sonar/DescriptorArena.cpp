@@ -0,0 +1,48 @@
+#include "DescriptorArena.h"
+
+DescriptorArena::DescriptorArena():
+    m_used(0)
+{
+}
+
+DescriptorArena::~DescriptorArena()
+{
+    for(unsigned i = 0 ; i < m_descriptors.size(); i++)
+        delete m_descriptors[i];
+}
+
+/**
+ * @brief Take an empty descriptor, owned by the arena
+ * until the next reset().
+ */
+SonarDescritor *DescriptorArena::newDescriptor()
+{
+    boost::mutex::scoped_lock lock(m_mtx);
+
+    if(m_used == m_descriptors.size())
+        m_descriptors.push_back(new SonarDescritor);
+
+    SonarDescritor *sd = m_descriptors[m_used++];
+    sd->reset();
+    return sd;
+}
+
+/**
+ * @brief Give back all descriptors, their pointers
+ * must not be used anymore.
+ */
+void DescriptorArena::reset()
+{
+    m_used = 0;
+}
+
+/**
+ * @brief Bytes reserved by the arena descriptors.
+ */
+size_t DescriptorArena::capacity() const
+{
+    size_t total = 0;
+    for(unsigned i = 0 ; i < m_descriptors.size(); i++)
+        total+= sizeof(SonarDescritor) + m_descriptors[i]->capacity();
+    return total;
+}
@@ -0,0 +1,51 @@
+#ifndef DESCRIPTORARENA_H
+#define DESCRIPTORARENA_H
+
+#include <vector>
+#include <cstddef>
+
+#include <boost/thread/mutex.hpp>
+
+#include "SonarDescritor.h"
+
+using namespace std;
+
+/**
+ * @brief Monotonic pool of SonarDescritor for one frame or a
+ * batch of frames.
+ *
+ *  Descriptors taken from the arena are never deleted one by one,
+ * reset() gives all of them back at once. The next batch reuses
+ * them with their Gaussians, links and CSR buffers, so after the
+ * first batch describing a frame almost doesn't call malloc and
+ * the memory used is the peak of previous batches (capacity()).
+ *  newDescriptor() is thread safe, reset() must not run while
+ * descriptors are taken or used.
+ */
+class DescriptorArena
+{
+    vector<SonarDescritor*> m_descriptors;
+    unsigned m_used; // Descriptors given on current batch
+
+    boost::mutex m_mtx;
+
+    // Not copyable
+    DescriptorArena(const DescriptorArena &);
+    DescriptorArena &operator=(const DescriptorArena &);
+
+public:
+    DescriptorArena();
+    ~DescriptorArena();
+
+    SonarDescritor *newDescriptor();
+    void reset();
+
+    unsigned size() const
+    {
+        return m_used;
+    }
+
+    size_t capacity() const;
+};
+
+#endif // DESCRIPTORARENA_H
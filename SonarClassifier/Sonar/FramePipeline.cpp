@@ -0,0 +1,169 @@
+#include "FramePipeline.h"
+#include "Sonar.h"
+
+#include <map>
+#include <iostream>
+#include <algorithm>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+void FramePipeline::decodeWorker()
+{
+    while(true)
+    {
+        unsigned id;
+        {
+            boost::mutex::scoped_lock lock(stageMtx);
+            if(nextFrame >= fileNames->size())
+                break;
+            id = nextFrame++;
+        }
+
+        PipelineFrame *fr = new PipelineFrame(id,(*fileNames)[id]);
+        fr->img = imread(fr->fileName.c_str(),CV_LOAD_IMAGE_ANYDEPTH);
+
+        if(fr->img.empty())
+            cout << "FramePipeline: It was not possible to read image " << fr->fileName << endl;
+
+        decodedQ.push(fr);
+    }
+
+    boost::mutex::scoped_lock lock(stageMtx);
+    if(--decodeRunning == 0)
+        decodedQ.close();
+}
+
+void FramePipeline::describeWorker(Sonar *sonar)
+{
+    PipelineFrame *fr;
+    while(decodedQ.pop(fr))
+    {
+        if(fr->img.empty())
+            fr->sd = arena != 0x0 ? arena->newDescriptor() : new SonarDescritor;
+        else
+            fr->sd = sonar->describe(fr->img);
+
+        fr->img.release();
+        describedQ.push(fr);
+    }
+
+    boost::mutex::scoped_lock lock(stageMtx);
+    if(--describeRunning == 0)
+        describedQ.close();
+}
+
+FramePipeline::FramePipeline(const char *configFileName):
+    configFileName(configFileName),
+    decodeThreads(1), describeThreads(0), queueSize(8),
+    arena(0x0),
+    fileNames(0x0), nextFrame(0),
+    decodeRunning(0), describeRunning(0)
+{
+    ConfigLoader config(configFileName);
+    load(config);
+}
+
+void FramePipeline::load(ConfigLoader &config)
+{
+    int iv;
+
+    if(config.getInt("FramePipeline","DecodeThreads",&iv))
+        setDecodeThreads(iv);
+
+    if(config.getInt("FramePipeline","DescribeThreads",&iv))
+        setDescribeThreads(iv);
+
+    if(config.getInt("FramePipeline","QueueSize",&iv))
+        setQueueSize(iv);
+}
+
+void FramePipeline::setDecodeThreads(unsigned n)
+{
+    decodeThreads = max(1u,n);
+}
+
+/**
+ * @brief Set the number of describe workers, 0 means one
+ * worker per hardware thread.
+ */
+void FramePipeline::setDescribeThreads(unsigned n)
+{
+    describeThreads = n;
+}
+
+void FramePipeline::setQueueSize(unsigned n)
+{
+    queueSize = max(1u,n);
+}
+
+/**
+ * @brief Take all descriptors from arena (0x0 to allocate
+ * each one), the describe workers share it.
+ */
+void FramePipeline::setDescriptorArena(DescriptorArena *arena)
+{
+    this->arena = arena;
+}
+
+/**
+ * @brief Describe all images and deliver the descriptors
+ * to sink in the fileNames order. It returns when all
+ * frames were delivered.
+ */
+void FramePipeline::run(const vector<string> &fileNames, FramePipelineSink &sink)
+{
+    unsigned nDescribe = describeThreads;
+    if(nDescribe == 0)
+        nDescribe = max(1u, boost::thread::hardware_concurrency());
+
+    this->fileNames = &fileNames;
+    nextFrame = 0;
+    decodeRunning = decodeThreads;
+    describeRunning = nDescribe;
+    decodedQ.reset(queueSize);
+    describedQ.reset(queueSize);
+
+    // One Sonar per describe worker, Segmentation isn't thread safe
+    ConfigLoader config(configFileName.c_str());
+    vector<Sonar*> sonars;
+    for(unsigned i = 0 ; i < nDescribe ; i++)
+    {
+        sonars.push_back(new Sonar(config,false));
+        sonars.back()->setDescriptorArena(arena);
+    }
+
+    boost::thread_group workers;
+    for(unsigned i = 0 ; i < decodeThreads ; i++)
+        workers.create_thread(boost::bind(&FramePipeline::decodeWorker,this));
+    for(unsigned i = 0 ; i < nDescribe ; i++)
+        workers.create_thread(boost::bind(&FramePipeline::describeWorker,this,sonars[i]));
+
+    // Sequential stage, frames are delivered in input order
+    map<unsigned, PipelineFrame*> pending;
+    unsigned next = 0;
+    PipelineFrame *fr;
+    while(describedQ.pop(fr))
+    {
+        pending[fr->id] = fr;
+
+        map<unsigned, PipelineFrame*>::iterator it;
+        while((it = pending.find(next)) != pending.end())
+        {
+            fr = it->second;
+            pending.erase(it);
+            sink.newFrame(fr->id,fr->fileName,fr->sd);
+            delete fr;
+            next++;
+        }
+    }
+
+    workers.join_all();
+
+    for(unsigned i = 0 ; i < sonars.size() ; i++)
+        delete sonars[i];
+
+    this->fileNames = 0x0;
+}
@@ -0,0 +1,97 @@
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+#include <string>
+
+#include <boost/thread/mutex.hpp>
+
+#include "SonarDescritor.h"
+#include "DescriptorArena.h"
+#include "SonarConfig/ConfigLoader.h"
+#include "Tools/BoundedQueue.h"
+
+using namespace std;
+using namespace cv;
+
+class Sonar;
+
+/**
+ * @brief Frame travelling through the FramePipeline stages.
+ */
+class PipelineFrame
+{
+public:
+    PipelineFrame(unsigned id=0, const string &fileName=""):
+        id(id), fileName(fileName), sd(0x0){}
+
+    unsigned id;      /**< Input order of the frame */
+    string fileName;
+    Mat img;          /**< 16 bits image, released after description */
+    SonarDescritor *sd;
+};
+
+/**
+ * @brief Last (sequential) stage of the FramePipeline, it
+ * receives the descriptors in input order.
+ */
+class FramePipelineSink
+{
+public:
+    virtual ~FramePipelineSink(){}
+
+    /**
+     * @param id - Input order of the frame.
+     * @param sd - New descriptor, the sink takes its ownership
+     * (unless the pipeline has a DescriptorArena).
+     */
+    virtual void newFrame(unsigned id, const string &fileName, SonarDescritor *sd) = 0;
+};
+
+/**
+ * @brief Streaming frame description.
+ *  Decode workers read the images, describe workers run
+ * Segmentation, Gaussians and graph creation with their own Sonar,
+ * and the calling thread delivers the descriptors in order to a
+ * FramePipelineSink. Stages are connected by bounded queues, so
+ * image reading overlaps with description and memory use doesn't
+ * depend on the number of frames.
+ *  Segmentation and Gaussian creation share a stage because the
+ * segments are pooled inside each Segmentation instance.
+ */
+class FramePipeline
+{
+    string configFileName;
+
+    unsigned decodeThreads, describeThreads, queueSize;
+
+    DescriptorArena *arena; // If not null, descriptors come from it
+
+    BoundedQueue<PipelineFrame*> decodedQ, describedQ;
+
+    // Decode stage input
+    const vector<string> *fileNames;
+    unsigned nextFrame;
+
+    boost::mutex stageMtx;
+    unsigned decodeRunning, describeRunning;
+
+    void decodeWorker();
+    void describeWorker(Sonar *sonar);
+
+public:
+    FramePipeline(const char *configFileName);
+
+    void load(ConfigLoader &config);
+
+    void setDecodeThreads(unsigned n);
+    void setDescribeThreads(unsigned n);
+    void setQueueSize(unsigned n);
+    void setDescriptorArena(DescriptorArena *arena);
+
+    void run(const vector<string> &fileNames, FramePipelineSink &sink);
+};
+
+#endif // FRAMEPIPELINE_H
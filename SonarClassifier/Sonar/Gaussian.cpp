@@ -35,7 +35,7 @@ Gaussian::Gaussian(Segment *seg, float std):
 
 void Gaussian::createGaussian3x3(Segment *seg, float std)
 {
-    Mat sample = seg->result(Rect(0,0,seg->N,3)),
+    Mat sample = seg->pixels(),
         mCov, mMean, eVal, eVect;
 
     // Calculate Covariance Matrix of the sample found
@@ -65,52 +65,34 @@ void Gaussian::createGaussian3x3(Segment *seg, float std)
 
 }
 
+/**
+ * @brief Mean, covariance and its eigen decomposition come from
+ * the moments accumulated by the segment extractor (seg->moments),
+ * so it costs O(1), no pass on pixels.
+ */
 void Gaussian::createGaussian2x2(Segment *seg, float std)
 {
-    Mat mCov, mMean, eVal, eVect;
+    const SegmentMoments &sm = seg->moments;
+    double major, minor, axisAng;
+    sm.principalAxes(&major, &minor, &axisAng);
 
-    // Intensity mean and std
-    Scalar iMean, iStd;
-    // Rect(x,y, widht, height) (result line 2 are intensitys found)
-    meanStdDev(seg->result(Rect(0,2,seg->N,1)),iMean ,iStd);
+    x = sm.meanCol();
+    y = sm.meanRow();
 
-//    cout << "Intensity mean and standard derivation (STD): "
-//         << iMean.val[0] << " " << iStd.val[0]
-//         << endl;
+    dx = sqrt(minor) * std;
+    dy = sqrt(major) * std; // Greater eigenValue
 
-    // Calculate Covariance Matrix of the sample found
-    calcCovarMatrix(seg->result(Rect(0,0,seg->N,2)), mCov, mMean,
-                    CV_COVAR_NORMAL | CV_COVAR_COLS | CV_COVAR_SCALE,
-                    CV_32F);
-
-//    cout << "CovarianceMatrix (XvsY)"
-//         << endl
-//         << mCov
-//         << endl
-//         << "Mean Matrix"
-//         << mMean
-//         << endl;
-
-    // Calculate EigenValues and EigenVector of Covariance Matrix
-    eigen(mCov, eVal, eVect);
-
-    y = mMean.at<float>(0,0);
-    x = mMean.at<float>(1,0);
-    intensity = iMean.val[0];
-
-    dx = sqrt(eVal.at<float>(1,0)) * std;
-    dy = sqrt(eVal.at<float>(0,0)) * std;// Greater eigenValue
-    di = iStd.val[0] * std;
-    N = seg->N;
-
-    // Compute Gaussian angle using the tangent of greater eigenVector
-    float fAng;
-    fAng = 180.0*atan2(eVect.at<float>(0,1),-eVect.at<float>(0,0))/M_PI; // Horizontal (to north) image reference
-    if(fAng<0.f) fAng+= 180.f;
+    // Principal axis (row,col) = (cos,sin) of axisAng,
+    // horizontal (north), to up, is the image reference 0 degrees
+    float fAng = 180.f - axisAng*180.0/M_PI;
+    if(fAng > 180.f) fAng-= 180.f;
 
     ang = fAng;
 
-    return;
+    // Intensity mean and std
+    intensity = sm.meanIntensity();
+    di = sm.stdIntensity() * std;
+    N = seg->N;
 }
 
 void Gaussian::clockWisePoints(Point2f &a, Point2f &b, Point2f &c, Point2f &d) const
@@ -261,15 +243,15 @@ void Gaussian::createCrazzyGaussian(Mat &img16Bits, Segment *seg, float std)
 
     // Intensity mean and std
     Scalar iMean, iStd;
-    // Rect(x,y, widht, height) (result line 2 are intensitys found)
-    meanStdDev(seg->result(Rect(0,2,seg->N,1)),iMean ,iStd);
+    // Intensities found (result.intensity array)
+    meanStdDev(seg->intensities(),iMean ,iStd);
 
 //    cout << "Intensity mean and standard derivation (STD): "
 //         << iMean.val[0] << " " << iStd.val[0]
 //         << endl;
 
     // Calculate Covariance Matrix of the sample found
-    calcCovarMatrix(seg->result(Rect(0,0,seg->N,2)), mCov, mMean,
+    calcCovarMatrix(seg->positions(), mCov, mMean,
                     CV_COVAR_NORMAL | CV_COVAR_COLS | CV_COVAR_SCALE,
                     CV_32F);
 
@@ -306,7 +288,7 @@ void Gaussian::createCrazzyGaussian(Mat &img16Bits, Segment *seg, float std)
     // ============= First cut ==========================
     RotatedRect rotRect( Point2f(x,y),Size2f(mdy,mdx), ang-90.f );
     Rect rect(rotRect.boundingRect()); // Crop to extrac segment of image
-    img = img16Bits(rect).clone();
+    Mat img = img16Bits(rect).clone();
     // ==================================================
 
     // Our new center after crop
@@ -414,8 +396,8 @@ void Gaussian::createCrazzyGaussian2(Mat &img16Bits, Segment *seg, float std)
     // Intensity mean and std
     Scalar iMean, iStd;
 
-    // Rect(x,y, widht, height) (result line 2 are intensitys found)
-    meanStdDev(seg->result(Rect(0,2,seg->N,1)),iMean ,iStd);
+    // Intensities found (result.intensity array)
+    meanStdDev(seg->intensities(),iMean ,iStd);
     intensity = iMean.val[0];
     di = iStd.val[0] * std;
 
@@ -504,7 +486,7 @@ void Gaussian::createCrazzyGaussian3(Mat &img16Bits, Segment *seg, float std)
     convexHullArea = contourArea(contours[ConvHullId]);
 
     Mat mCov, mMean, eVal, eVect;
-    calcCovarMatrix(seg->result(Rect(0,0,seg->N,2)), mCov, mMean,
+    calcCovarMatrix(seg->positions(), mCov, mMean,
                     CV_COVAR_NORMAL | CV_COVAR_COLS | CV_COVAR_SCALE,
                     CV_32F);
     eigen(mCov, eVal, eVect);
@@ -524,8 +506,8 @@ void Gaussian::createCrazzyGaussian3(Mat &img16Bits, Segment *seg, float std)
     // Intensity mean and std
     Scalar iMean, iStd;
 
-    // Rect(x,y, widht, height) (result line 2 are intensitys found)
-    meanStdDev(seg->result(Rect(0,2,seg->N,1)),iMean ,iStd);
+    // Intensities found (result.intensity array)
+    meanStdDev(seg->intensities(),iMean ,iStd);
     intensity = iMean.val[0];
     di = iStd.val[0] * std;
 
@@ -593,7 +575,6 @@ void Gaussian::createCrazzyGaussian3(Mat &img16Bits, Segment *seg, float std)
 
 void Gaussian::createGaussianFinal(Mat &img16Bits, Segment *seg, float std)
 {
-    N = seg->N;
     perimeter = seg->NCountor; // Border pixel count
     area = seg->N; // Total pixel count
 
@@ -616,54 +597,25 @@ void Gaussian::createGaussianFinal(Mat &img16Bits, Segment *seg, float std)
 
     convexHullArea = contourArea(contours[ConvHullId]);
 
-    Mat mCov, // Covariance Matrix
-       mMean, // Pixel means
-       eVal, eVect; // eigenvalues and eigenvectors
-
-    calcCovarMatrix(seg->result(Rect(0,0,seg->N,2)), mCov, mMean,
-                    CV_COVAR_NORMAL | CV_COVAR_COLS | CV_COVAR_SCALE,
-                    CV_32F);
-
-    eigen(mCov, eVal, eVect);
-
-    x = mMean.at<float>(1,0);
-    y = mMean.at<float>(0,0);
-
-    dx = sqrt(eVal.at<float>(1,0)) * std;
-    dy = sqrt(eVal.at<float>(0,0)) * std;
-
-    float fAng;
-    fAng = 180.0*atan2(eVect.at<float>(0,1),-eVect.at<float>(0,0))/M_PI; // Horizontal (north), to up, is the image reference 0 degrees
-    if(fAng<0.f) fAng+= 180.f;
-
-    ang = fAng;
-
-    // Intensity mean and std
-    Scalar iMean, iStd;
-
-    // Rect(x,y, widht, height) (result line 2 are intensitys found)
-    meanStdDev(seg->result(Rect(0,2,seg->N,1)),
-               iMean ,iStd);
-
-    intensity = iMean.val[0];
-    di = iStd.val[0] * std;
+    // Mean, covariance and principal axes from the segment moments
+    createGaussian2x2(seg,std);
 
     if(area >convexHullArea) convexHullArea = area;
 
+    #ifdef GAUSSIAN_DEBUG
     cout << "==== 10D Features ==========" << endl
          << "Area = " << area << endl
          << "Perimeter = " << perimeter << endl  // Perimeter
          << "Convex Hull Area = " << convexHullArea << endl
-         << "Convex Hull Perimeter = " << convexHullArea << endl // Convex hull perimeter
          << "Width = " << dx << endl  // Width
          << "Height = " << dy << endl  // Height
          << "Inertia Ratio = " << dx / dy << endl // Inertia Ratio - circularty (circle = 1 line = 0)
          << "Std. Intensity = " << di << endl // Std Intensity
          << "Mean Intensity = " << intensity << endl // Mean Intensity
-         << "Area = " << area << endl  // Area
          << "Convexity = " << area / convexHullArea << endl //Convexity
          << "Pixel Count = " << N  // Pixel Count
          << endl << endl;
+    #endif
 
 
     #ifdef GAUSSIAN_DEBUG
@@ -730,8 +682,8 @@ void Gaussian::findOrderedContour(Segment *seg, vector<Mat> &contour)
 
     for(unsigned i = 0; i < seg->N;i++)
     {
-        m.at<uchar>( seg->result.at<ushort>(0,i) -seg->mRow,
-                     seg->result.at<ushort>(1,i) -seg->mCol) = 255u;
+        m.at<uchar>( seg->result.row[i] -seg->mRow,
+                     seg->result.col[i] -seg->mCol) = 255u;
     }
 
     Mat view;
@@ -821,7 +773,7 @@ ostream & operator <<(ostream &os, const Gaussian& g)
 
 //    // Intensity mean and std
 //    Scalar iMean, iStd;
-//    // Rect(x,y, widht, height) (result line 2 are intensitys found)
+//    // Intensities found (result.intensity array)
 //    meanStdDev(seg->result(Rect(0,2,seg->N,1)),iMean ,iStd);
 
 ////    cout << "Intensity mean and standard derivation (STD): "
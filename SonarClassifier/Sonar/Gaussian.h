@@ -67,9 +67,6 @@ public:
     void findOrderedContour(Segment *seg, vector<Mat> &contour);
 
     void rotatedRectCrop(Mat &img16Bits, const RotatedRect &rotRect, Mat &result, int scale=1);
-
-    Mat img;
-
 };
 
 ostream & operator <<(ostream &os, const Gaussian& g);
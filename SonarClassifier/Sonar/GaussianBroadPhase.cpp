@@ -0,0 +1,110 @@
+#include "GaussianBroadPhase.h"
+
+#include <algorithm>
+#include <functional>
+
+// Float rounding margin, hasIntersection accepts points on the edges
+#define BROAD_PHASE_MARGIN 1.f
+
+GaussianBroadPhase::GaussianBroadPhase():
+    m_maxWidth(0.f)
+{
+}
+
+void GaussianBroadPhase::box(const Gaussian &g, float *minX, float *maxX,
+                                                 float *minY, float *maxY)
+{
+    Point2f p[4];
+    g.clockWisePoints(p[0],p[1],p[2],p[3]);
+
+    *minX = *maxX = p[0].x;
+    *minY = *maxY = p[0].y;
+    for(unsigned i = 1 ; i < 4 ; i++)
+    {
+        *minX = min(*minX, p[i].x); *maxX = max(*maxX, p[i].x);
+        *minY = min(*minY, p[i].y); *maxY = max(*maxY, p[i].y);
+    }
+
+    *minX-= BROAD_PHASE_MARGIN; *maxX+= BROAD_PHASE_MARGIN;
+    *minY-= BROAD_PHASE_MARGIN; *maxY+= BROAD_PHASE_MARGIN;
+}
+
+void GaussianBroadPhase::insertSweep(unsigned id)
+{
+    pair<float,unsigned> e(m_minX[id], id);
+    m_sweep.insert(upper_bound(m_sweep.begin(), m_sweep.end(), e), e);
+    m_maxWidth = max(m_maxWidth, m_maxX[id] - m_minX[id]);
+}
+
+void GaussianBroadPhase::clear()
+{
+    m_minX.clear(); m_maxX.clear();
+    m_minY.clear(); m_maxY.clear();
+    m_sweep.clear();
+    m_maxWidth = 0.f;
+}
+
+void GaussianBroadPhase::build(const vector<Gaussian> &gaussians)
+{
+    clear();
+    for(unsigned i = 0 ; i < gaussians.size() ; i++)
+        add(gaussians[i]);
+}
+
+/**
+ * @brief Insert a new Gaussian.
+ * @return Its id.
+ */
+unsigned GaussianBroadPhase::add(const Gaussian &g)
+{
+    unsigned id = m_minX.size();
+    float minX, maxX, minY, maxY;
+    box(g, &minX, &maxX, &minY, &maxY);
+
+    m_minX.push_back(minX); m_maxX.push_back(maxX);
+    m_minY.push_back(minY); m_maxY.push_back(maxY);
+    insertSweep(id);
+
+    return id;
+}
+
+/**
+ * @brief Change the box of Gaussian id (after a merge).
+ */
+void GaussianBroadPhase::update(unsigned id, const Gaussian &g)
+{
+    vector<pair<float,unsigned> >::iterator it =
+            lower_bound(m_sweep.begin(), m_sweep.end(),
+                        make_pair(m_minX[id], id));
+    m_sweep.erase(it);
+
+    box(g, &m_minX[id], &m_maxX[id], &m_minY[id], &m_maxY[id]);
+    insertSweep(id);
+}
+
+/**
+ * @brief Ids of the Gaussians whose boxes overlap the g box,
+ * in decreasing order (the merge search order).
+ */
+void GaussianBroadPhase::candidates(const Gaussian &g, vector<unsigned> &ids) const
+{
+    ids.clear();
+    if(m_sweep.empty()) return;
+
+    float minX, maxX, minY, maxY;
+    box(g, &minX, &maxX, &minY, &maxY);
+
+    // Only boxes starting on [minX - m_maxWidth , maxX] can overlap
+    vector<pair<float,unsigned> >::const_iterator
+            it = lower_bound(m_sweep.begin(), m_sweep.end(),
+                             make_pair(minX - m_maxWidth, 0u));
+
+    for(; it != m_sweep.end() && it->first <= maxX ; it++)
+    {
+        unsigned j = it->second;
+        if(m_maxX[j] >= minX && m_minY[j] <= maxY && m_maxY[j] >= minY)
+            ids.push_back(j);
+    }
+
+    sort(ids.begin(), ids.end(), greater<unsigned>());
+}
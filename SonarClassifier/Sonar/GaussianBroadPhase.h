@@ -0,0 +1,48 @@
+#ifndef GAUSSIANBROADPHASE_H
+#define GAUSSIANBROADPHASE_H
+
+#include <vector>
+#include "Gaussian.h"
+
+using namespace std;
+
+/**
+ * @brief Sweep and prune list of Gaussian bounding boxes, used to
+ * find the merge candidates of a new Gaussian without running
+ * Gaussian::hasIntersection against all previous ones.
+ *
+ *  Boxes bound the clockWisePoints of each Gaussian (the shape
+ * tested by hasIntersection) with a small margin. They're kept
+ * sorted by left side, a query scans only the boxes starting
+ * between (left - widest box) and its right side.
+ *  Gaussians are identified by their insertion order.
+ */
+class GaussianBroadPhase
+{
+    vector<float> m_minX, m_maxX, m_minY, m_maxY; // Box of each Gaussian id
+    vector<pair<float,unsigned> > m_sweep; // (minX, id) sorted by minX
+    float m_maxWidth;
+
+    static void box(const Gaussian &g, float *minX, float *maxX,
+                                       float *minY, float *maxY);
+
+    void insertSweep(unsigned id);
+
+public:
+    GaussianBroadPhase();
+
+    void clear();
+    void build(const vector<Gaussian> &gaussians);
+
+    unsigned add(const Gaussian &g);
+    void update(unsigned id, const Gaussian &g);
+
+    void candidates(const Gaussian &g, vector<unsigned> &ids) const;
+
+    unsigned size() const
+    {
+        return m_minX.size();
+    }
+};
+
+#endif // GAUSSIANBROADPHASE_H
@@ -0,0 +1,98 @@
+#include "GaussianGrid.h"
+
+#include <cmath>
+#include <algorithm>
+
+GaussianGrid::GaussianGrid():
+    m_minX(0.f), m_minY(0.f), m_cellSize(1.f),
+    m_cols(0), m_rows(0)
+{
+}
+
+int GaussianGrid::cellCol(float x) const
+{
+    int c = (int)((x - m_minX)/m_cellSize);
+    return std::min(std::max(c,0), m_cols-1);
+}
+
+int GaussianGrid::cellRow(float y) const
+{
+    int r = (int)((y - m_minY)/m_cellSize);
+    return std::min(std::max(r,0), m_rows-1);
+}
+
+/**
+ * @brief Index the Gaussian centres in cells of at least cellSize.
+ */
+void GaussianGrid::build(const vector<GaussianVertex> &vertices, float cellSize)
+{
+    unsigned n = vertices.size();
+
+    m_items.clear();
+    m_cellStart.clear();
+    m_cols = m_rows = 0;
+    if(n == 0) return;
+
+    float maxX = vertices[0].x, maxY = vertices[0].y;
+    m_minX = maxX; m_minY = maxY;
+    for(unsigned i = 1 ; i < n ; i++)
+    {
+        m_minX = std::min(m_minX, vertices[i].x);
+        m_minY = std::min(m_minY, vertices[i].y);
+        maxX = std::max(maxX, vertices[i].x);
+        maxY = std::max(maxY, vertices[i].y);
+    }
+
+    // Limit the cells count to ~4n
+    float w = maxX - m_minX, h = maxY - m_minY,
+          minCellSize = sqrt(w*h/(4.f*n));
+
+    // A bit bigger, so float rounding never puts points at
+    // distance cellSize two cells apart
+    m_cellSize = std::max(cellSize*1.001f, minCellSize);
+    m_cellSize = std::max(m_cellSize, std::max(w,h)/(4.f*n));
+    if(!(m_cellSize > 0.f)) m_cellSize = 1.f;
+
+    m_cols = (int)(w/m_cellSize) + 1;
+    m_rows = (int)(h/m_cellSize) + 1;
+
+    // Counting sort of Gaussians by cell, keeping ids order in each cell
+    vector<unsigned> cellOf(n);
+    m_cellStart.assign(m_cols*m_rows+1, 0);
+    for(unsigned i = 0 ; i < n ; i++)
+    {
+        cellOf[i] = cellRow(vertices[i].y)*m_cols + cellCol(vertices[i].x);
+        m_cellStart[cellOf[i]+1]++;
+    }
+
+    for(unsigned c = 1 ; c < m_cellStart.size() ; c++)
+        m_cellStart[c]+= m_cellStart[c-1];
+
+    vector<unsigned> fill(m_cellStart.begin(), m_cellStart.end()-1);
+    m_items.resize(n);
+    for(unsigned i = 0 ; i < n ; i++)
+        m_items[fill[cellOf[i]]++] = i;
+}
+
+/**
+ * @brief Ids of Gaussians on the 3x3 cells around (x,y), a superset
+ * of the Gaussians at distance <= cellSize. The ids aren't sorted.
+ */
+void GaussianGrid::candidates(float x, float y, vector<unsigned> &ids) const
+{
+    ids.clear();
+    if(m_items.empty()) return;
+
+    int col = cellCol(x), row = cellRow(y);
+
+    for(int r = std::max(row-1,0) ; r <= std::min(row+1,m_rows-1) ; r++)
+    {
+        for(int c = std::max(col-1,0) ; c <= std::min(col+1,m_cols-1) ; c++)
+        {
+            unsigned cell = r*m_cols + c;
+            ids.insert(ids.end(),
+                       m_items.begin() + m_cellStart[cell],
+                       m_items.begin() + m_cellStart[cell+1]);
+        }
+    }
+}
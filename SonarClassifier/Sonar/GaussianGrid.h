@@ -0,0 +1,38 @@
+#ifndef GAUSSIANGRID_H
+#define GAUSSIANGRID_H
+
+#include <vector>
+#include "GaussianVertex.h"
+
+using namespace std;
+
+/**
+ * @brief Uniform grid over Gaussian centres, used to find the
+ * Gaussians closer than a link distance without testing all pairs.
+ *
+ *  Cells are at least cellSize wide, so all Gaussians at distance
+ * <= cellSize of a point are on its 3x3 cells. Cells are stored
+ * as a compressed list (counting sort), the grid has at most
+ * about 4 cells per Gaussian, bigger cells are used when the
+ * Gaussians are too spread for the requested size.
+ */
+class GaussianGrid
+{
+    float m_minX, m_minY, m_cellSize;
+    int m_cols, m_rows;
+
+    vector<unsigned> m_cellStart, // Cell c items are m_items[m_cellStart[c] , m_cellStart[c+1])
+                     m_items;     // Gaussian ids ordered by cell
+
+    int cellCol(float x) const;
+    int cellRow(float y) const;
+
+public:
+    GaussianGrid();
+
+    void build(const vector<GaussianVertex> &vertices, float cellSize);
+
+    void candidates(float x, float y, vector<unsigned> &ids) const;
+};
+
+#endif // GAUSSIANGRID_H
@@ -62,17 +62,8 @@ void GaussianTest::start()
 
 void GaussianTest::clear()
 {
-    int maxSampleSize= 120000;
     // Initialize/Clear segment
-    sample.N = 0;
-    sample.MCol = sample.MRow = 0;
-    sample.mRow = sample.mCol = 99999;
-
-    // Realocate memory if necsessary
-    if(sample.result.rows < 3 || sample.result.cols < maxSampleSize)
-    {
-        sample.result = Mat(3, maxSampleSize , CV_16UC1, Scalar(0));
-    }
+    sample.clear();
 }
 
 void GaussianTest::mouseEvent(int event, int x, int y)
@@ -81,10 +72,7 @@ void GaussianTest::mouseEvent(int event, int x, int y)
     if(event == CV_EVENT_LBUTTONDOWN)
     {
         // Register element
-        sample.result.at<ushort>(0,sample.N) = y;
-        sample.result.at<ushort>(1,sample.N) = x;
-        sample.result.at<ushort>(2,sample.N) = 100;
-        sample.N++;
+        sample.addPixel(y,x,100);
 
         // Take min max col and y
         if(sample.MRow < y)
@@ -0,0 +1,19 @@
+#include "GaussianVertex.h"
+
+#include <cmath>
+
+float dist(const GaussianVertex &a, const GaussianVertex &b)
+{
+    float dx = a.x - b.x,
+          dy = a.y - b.y;
+    return sqrt(dx*dx + dy*dy);
+}
+
+float angleBetween(const GaussianVertex &a, const GaussianVertex &center, const GaussianVertex &b)
+{
+    float x1 = a.x - center.x, y1 = a.y - center.y,
+          x2 = b.x - center.x, y2 = b.y - center.y,
+          dot = x1*x2 + y1*y2,      // dot product
+          det = x1*y2 - y1*x2;      // determinant
+    return atan2(det, dot)*(180/M_PI);
+}
@@ -0,0 +1,30 @@
+#ifndef GAUSSIANVERTEX_H
+#define GAUSSIANVERTEX_H
+
+#include "Gaussian.h"
+
+/**
+ * @brief Packed copy of the Gaussian fields used by graph
+ * building and matching, 32 bytes (two vertex per cache line).
+ *  Shape descriptors (Hu moments, area, perimeter, ...) stay
+ * only on Gaussian.
+ */
+class GaussianVertex
+{
+public:
+    GaussianVertex(){}
+
+    GaussianVertex(const Gaussian &g):
+        x(g.x), y(g.y), intensity(g.intensity),
+        dx(g.dx), dy(g.dy), di(g.di), ang(g.ang), N(g.N){}
+
+    float x, y, intensity,
+          dx, dy, di, ang;
+
+    unsigned N;
+};
+
+float dist(const GaussianVertex &a, const GaussianVertex &b);
+float angleBetween(const GaussianVertex &a, const GaussianVertex &center, const GaussianVertex &b);
+
+#endif // GAUSSIANVERTEX_H
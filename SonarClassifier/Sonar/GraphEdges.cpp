@@ -0,0 +1,64 @@
+#include "GraphEdges.h"
+
+#include <algorithm>
+
+// Compare edge ids by length, ties by id
+class EdgeLengthLess
+{
+    const float *m_p;
+public:
+    EdgeLengthLess(const float *p):m_p(p){}
+
+    bool operator()(unsigned a, unsigned b) const
+    {
+        return m_p[a] < m_p[b] || (m_p[a] == m_p[b] && a < b);
+    }
+};
+
+void GraphEdges::clear()
+{
+    vertexBegin.clear();
+    p.clear();
+    lengthOrder.clear();
+}
+
+/**
+ * @brief Index the graph edges, copying their lengths.
+ */
+void GraphEdges::build(const vector<vector<GraphLink *> > &graph)
+{
+    vertexBegin.resize(graph.size()+1);
+    vertexBegin[0] = 0;
+    for(unsigned v = 0 ; v < graph.size() ; v++)
+        vertexBegin[v+1] = vertexBegin[v] + graph[v].size();
+
+    unsigned nE = vertexBegin[graph.size()];
+    p.resize(nE);
+    lengthOrder.resize(nE);
+
+    for(unsigned v = 0 ; v < graph.size() ; v++)
+    {
+        unsigned e = vertexBegin[v];
+        for(unsigned k = 0 ; k < graph[v].size() ; k++, e++)
+        {
+            const GraphLink *l = graph[v][k];
+            p[e] = l->p;
+            lengthOrder[e] = k;
+        }
+
+        // Length signature
+        sort(lengthOrder.begin() + vertexBegin[v],
+             lengthOrder.begin() + vertexBegin[v+1],
+             EdgeLengthLess(nE > 0 ? &p[0] + vertexBegin[v] : 0x0));
+    }
+}
+
+/**
+ * @brief Bytes reserved by the CSR arrays.
+ */
+size_t GraphEdges::capacity() const
+{
+    return vertexBegin.capacity()*sizeof(unsigned) +
+           p.capacity()*sizeof(float) +
+           lengthOrder.capacity()*sizeof(unsigned);
+}
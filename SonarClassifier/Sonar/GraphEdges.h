@@ -0,0 +1,63 @@
+#ifndef GRAPHEDGES_H
+#define GRAPHEDGES_H
+
+#include <vector>
+#include <cstddef>
+#include "GraphLink.h"
+
+using namespace std;
+
+/**
+ * @brief Compressed sparse row (CSR) index of a SonarDescritor graph.
+ *
+ *  Edges of vertex v are [vertexBegin[v], vertexBegin[v+1]) on
+ * p and lengthOrder. Edge attributes are read from the graph
+ * links (SonarDescritor::links contiguous block).
+ *  Edge order is the graph order when build was called, the
+ * length signatures (byLength) are valid while graph vertex
+ * keep this order.
+ */
+class GraphEdges
+{
+public:
+    vector<unsigned> vertexBegin;
+
+    vector<float> p; // lenght od edge
+
+    vector<unsigned> lengthOrder; // Edges of each vertex (local ids) sorted by p
+
+    void clear();
+
+    void build(const vector<vector<GraphLink*> > &graph);
+
+    size_t capacity() const;
+
+    unsigned numberOfVertex() const
+    {
+        return vertexBegin.empty() ? 0u : vertexBegin.size()-1;
+    }
+
+    unsigned numberOfEdges() const
+    {
+        return p.size();
+    }
+
+    unsigned degree(unsigned v) const
+    {
+        return vertexBegin[v+1] - vertexBegin[v];
+    }
+
+    /**
+     * @brief Edge signature of vertex v, its degree(v) edge ids
+     * (positions on graph[v]) sorted by length, ties by id.
+     * @return 0x0 if v isn't on the CSR.
+     */
+    const unsigned *byLength(unsigned v) const
+    {
+        if(v >= numberOfVertex() || lengthOrder.empty())
+            return 0x0;
+        return &lengthOrder[0] + vertexBegin[v];
+    }
+};
+
+#endif // GRAPHEDGES_H
@@ -0,0 +1,100 @@
+#include "HighGuiSonarVisualizer.h"
+#include "Sonar.h"
+
+#include <cstdio>
+
+#include "Drawing/Drawing.h"
+
+void HighGuiSonarVisualizer::newDescriptor(Sonar &sonar, Mat &img16bits,
+                                           SonarDescritor *sd,
+                                           const vector<SonarDescritor *> &descriptors)
+{
+    char fileName[200];
+    unsigned frame = descriptors.size()-1;
+
+    // LSB IMAGE
+    Mat LSBImg;
+    img16bits.convertTo(LSBImg,CV_8U);
+
+    if(sonar.saveTruncateImg)
+    {
+        sprintf(fileName,"frame_%.5u_8bitsTrucate.png", frame);
+        imwrite(fileName, LSBImg);
+    }
+
+    if(sonar.storeImgs)
+        storedImgs.push_back(LSBImg.clone());
+
+    Mat colorImg;
+    cvtColor(LSBImg,colorImg,CV_GRAY2BGR);
+
+    resize(LSBImg,LSBImg,Size(800,600));
+    imshow("Least Significant Bit Truncate Image", LSBImg);
+
+    sonar.drawGaussians(colorImg,sd);
+
+    if(sonar.saveGraphImg)
+    {
+        sprintf(fileName,"frame_%.5u_Graph.png", frame);
+        imwrite(fileName, colorImg);
+    }
+
+    resize(colorImg,colorImg,Size(800,600));
+    imshow("Color Img", colorImg);
+
+    if(sonar.drawEachVetex)
+    {
+        for(unsigned i = 0 ; i < sd->gaussians.size() ; i ++)
+        {
+            Mat dVertex = Mat::zeros(img16bits.rows, img16bits.cols, CV_8UC3);
+            Drawing::drawVertex(dVertex, sd, i, Rect(0,0,dVertex.cols, dVertex.rows),
+                                       Scalar(0,255,0),Scalar(255,0,255));
+            imshow("Vertex", dVertex);
+            waitKey();
+        }
+    }
+
+    // Match with the previous frame only
+    if(descriptors.size() < 2)
+        return;
+
+    SonarDescritor *prev = descriptors[frame-1];
+    vector<MatchInfo> matches;
+    Mat sdImg1 = Mat::zeros(img16bits.rows,img16bits.cols,CV_8UC3),
+        sdImg2 = Mat::zeros(img16bits.rows,img16bits.cols,CV_8UC3),
+        matchImg = Mat::zeros(img16bits.rows,img16bits.cols,CV_8UC3);
+
+    sonar.matcher.findMatch(prev, sd,matches);
+
+    if(sonar.storeImgs && storedImgs.size() >= 2)
+        sonar.matcher.drawMatchOnImgs(matchImg,Size2i(img16bits.cols*1.2,img16bits.rows),
+                                      prev, storedImgs[storedImgs.size()-2],
+                                      sd, storedImgs[storedImgs.size()-1],
+                                      matches);
+    else
+        sonar.matcher.drawMatch(prev, sd,matches, matchImg);
+
+    sonar.drawGaussians(sdImg1,prev);
+    sonar.drawGaussians(sdImg2,sd);
+
+    if(sonar.saveMatchImgs)
+    {
+        sprintf(fileName,"frame_%.5u-%.5u_Graph_1.png", frame, frame+1);
+        imwrite(fileName, sdImg1);
+
+        sprintf(fileName,"frame_%.5u-%.5u_Graph_2.png", frame, frame+1);
+        imwrite(fileName, sdImg2);
+
+        sprintf(fileName,"frame_%.5u-%.5u_Match.png", frame, frame+1);
+        imwrite(fileName, matchImg);
+    }
+
+    resize(sdImg1,sdImg1,Size(800,600));
+    imshow("SD before", sdImg1);
+
+    resize(sdImg2,sdImg2,Size(800,600));
+    imshow("SD after", sdImg2);
+
+    resize(matchImg,matchImg,Size(1400,600));
+    imshow("Graph Match", matchImg);
+}
@@ -0,0 +1,31 @@
+#ifndef HIGHGUISONARVISUALIZER_H
+#define HIGHGUISONARVISUALIZER_H
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include <vector>
+
+#include "SonarVisualizer.h"
+
+using namespace std;
+using namespace cv;
+
+/**
+ * @brief Interactive visualizer used by Sonar::newImage().
+ *  It shows the described frame and its match with the
+ * previous frame on HighGUI windows, images are written
+ * on disk only when the Sonar save flags are enabled.
+ */
+class HighGuiSonarVisualizer : public SonarVisualizer
+{
+    vector<Mat> storedImgs;
+
+public:
+    void newDescriptor(Sonar &sonar, Mat &img16bits,
+                       SonarDescritor *sd,
+                       const vector<SonarDescritor*> &descriptors);
+};
+
+#endif // HIGHGUISONARVISUALIZER_H
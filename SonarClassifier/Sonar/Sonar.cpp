@@ -1,10 +1,12 @@
 #include "Sonar.h"
 #include "SonarDescritor.h"
+#include "GaussianBroadPhase.h"
 #include <iostream>
 #include <cstdio>
 #include "Sonar/SonarConfig/ConfigLoader.h"
 
 #include "Drawing/Drawing.h"
+#include "HighGuiSonarVisualizer.h"
 
 using namespace std;
 
@@ -29,30 +31,42 @@ void Sonar::createGaussian(Mat &img, SonarDescritor *sd,bool doMerge)
 
     vector<Gaussian> &gaussians = sd->gaussians;
 
+    // Only Gaussians with overlapping boxes are merge candidates
+    GaussianBroadPhase mergeIndex;
+    vector<unsigned> candidates;
+
     for(unsigned i = 0 ; i < seg.size() ; i++)
     {
         bool merged = false;
         Gaussian g(seg[i],stdDevMultiply);
 
         if(doMerge)
-        // Search segments to merge
-        for(int j = gaussians.size()-1 ; j >= 0; j--)
         {
-            if(Gaussian::hasIntersection(g,gaussians[j]))
+            // Search segments to merge (from the last one)
+            mergeIndex.candidates(g,candidates);
+            for(unsigned k = 0 ; k < candidates.size(); k++)
             {
-                cout << "Merge with " << j << endl;
-
-                seg[j]->merge(seg[i]);
-                gaussians[j].createGaussian2x2(seg[j],stdDevMultiply);
-//                gaussians[j].createCrazzyGaussian(img, seg[j],stdDevMultiply);
-
-                merged = true;
-                break;
+                unsigned j = candidates[k];
+                if(Gaussian::hasIntersection(g,gaussians[j]))
+                {
+                    cout << "Merge with " << j << endl;
+
+                    seg[j]->merge(seg[i]);
+                    gaussians[j].createGaussian2x2(seg[j],stdDevMultiply);
+//                    gaussians[j].createCrazzyGaussian(img, seg[j],stdDevMultiply);
+                    mergeIndex.update(j,gaussians[j]);
+
+                    merged = true;
+                    break;
+                }
             }
         }
 
         if(!merged)
+        {
            sd->addGaussian(g,false);
+           if(doMerge) mergeIndex.add(g);
+        }
     }
 
 //    pseudoMergeGaussian(0,1);
@@ -77,12 +91,18 @@ void Sonar::createGaussian(Mat &img, vector<Gaussian> &gs, bool doMerge)
     segmentation.segment(img,&seg);
     //    segmentation.interativeRTPlot(img);
 
+    // Only Gaussians with overlapping boxes are merge candidates
+    GaussianBroadPhase mergeIndex;
+    vector<unsigned> candidates;
+
     for(unsigned i = 0 ; i < seg.size() ; i++)
     {
         bool merged = false;
 //        Gaussian g(seg[i],stdDevMultiply);
         Gaussian g;
-        cout << "Gaussian " << i << endl;
+        #ifdef SONAR_DEBUG
+            cout << "Gaussian " << i << endl;
+        #endif
 //        g.createCrazzyGaussian3(img,seg[i],stdDevMultiply);
         g.createGaussianFinal(img,seg[i],stdDevMultiply);
 //        g.createGaussian2x2(seg[i],stdDevMultiply);
@@ -95,23 +115,31 @@ void Sonar::createGaussian(Mat &img, vector<Gaussian> &gs, bool doMerge)
         #endif
 
         if(doMerge)
-        // Search segments to merge
-        for(int j = gs.size()-1 ; j >= 0; j--)
         {
-            if(Gaussian::hasIntersection(g,gs[j]))
+            // Search segments to merge (from the last one)
+            mergeIndex.candidates(g,candidates);
+            for(unsigned k = 0 ; k < candidates.size(); k++)
             {
-                cout << "Merge with " << j << endl;
-
-                seg[j]->merge(seg[i]);
-                gs[j].createGaussian2x2(seg[j],stdDevMultiply);
-
-                merged = true;
-                break;
+                unsigned j = candidates[k];
+                if(Gaussian::hasIntersection(g,gs[j]))
+                {
+                    cout << "Merge with " << j << endl;
+
+                    seg[j]->merge(seg[i]);
+                    gs[j].createGaussian2x2(seg[j],stdDevMultiply);
+                    mergeIndex.update(j,gs[j]);
+
+                    merged = true;
+                    break;
+                }
             }
         }
 
         if(!merged)
+        {
             gs.push_back(g);
+            if(doMerge) mergeIndex.add(g);
+        }
     }
 
 #ifdef SONAR_DEBUG
@@ -285,9 +313,9 @@ void Sonar::mergeGaussian(SonarDescritor *sd, unsigned a, unsigned b)
 //    ang = calcGaussianAng(xMean_ab, yMean_ab,xStdDev_ab, yStdDev_ab,
 //                          Mx,MXy,My, MYx);
 
-    sd->gaussians.push_back(Gaussian(xMean_ab, yMean_ab, zMean_ab,
-                                 xStdDev_ab, yStdDev_ab, zStdDev_ab,
-                                 ang, N_ab));
+    sd->addGaussian(Gaussian(xMean_ab, yMean_ab, zMean_ab,
+                             xStdDev_ab, yStdDev_ab, zStdDev_ab,
+                             ang, N_ab));
 }
 
 void Sonar::pseudoMergeGaussian(SonarDescritor *sd, unsigned a, unsigned b)
@@ -361,9 +389,9 @@ void Sonar::pseudoMergeGaussian(SonarDescritor *sd, unsigned a, unsigned b)
     cout << "Merge b:" << gb.x << " , " << gb.y << " , " << gb.dx << " , " << gb.dy << endl;
     cout << "Resp   :" << xMean_ab << " , " << yMean_ab << " , " << xStdDev_ab << " , " << yStdDev_ab << endl;
 
-    sd->gaussians.push_back(Gaussian(xMean_ab, yMean_ab, zMean_ab,
-                                 xStdDev_ab, yStdDev_ab, zStdDev_ab,
-                                 ang, N_ab));
+    sd->addGaussian(Gaussian(xMean_ab, yMean_ab, zMean_ab,
+                             xStdDev_ab, yStdDev_ab, zStdDev_ab,
+                             ang, N_ab));
 }
 
 void Sonar::createGraph(SonarDescritor *sd)
@@ -379,26 +407,40 @@ void Sonar::createGraphNeighborRelative(SonarDescritor *sd)
 Sonar::Sonar(ConfigLoader &config, bool deleteDescriptors):
     deleteDescriptors(deleteDescriptors),
     stdDevMultiply(3.f),
-    graphLinkDistance(200.f)
+    graphLinkDistance(200.f),
+    descriptorArena(0x0),
+    visualizer(0x0),
+    deleteVisualizer(false)
 {
     drawEachVetex = false;
     storeImgs = false;
+    saveGraphImg = false;
+    saveTruncateImg = false;
+    saveMatchImgs = false;
     loadConfig(config);
 }
 
 Sonar::Sonar(bool deleteDescriptors):
     deleteDescriptors(deleteDescriptors),
     stdDevMultiply(3.f),
-    graphLinkDistance(200.f)
+    graphLinkDistance(200.f),
+    descriptorArena(0x0),
+    visualizer(0x0),
+    deleteVisualizer(false)
 {
     drawEachVetex = false;
     storeImgs = false;
+    saveGraphImg = false;
+    saveTruncateImg = false;
+    saveMatchImgs = false;
 }
 
 Sonar::~Sonar()
 {
     if(deleteDescriptors)
         clearDescriptors();
+
+    setVisualizer(0x0);
 }
 
 void Sonar::loadConfig(ConfigLoader &config)
@@ -413,6 +455,59 @@ void Sonar::loadConfig(ConfigLoader &config)
     }
 }
 
+/**
+ * @brief Set the visualizer used by newImage(),
+ * if it's null newImage() will use a HighGuiSonarVisualizer.
+ *
+ * @param visualizer - New visualizer or 0x0.
+ * @param deleteVisualizer - If Sonar takes the visualizer ownership.
+ */
+void Sonar::setVisualizer(SonarVisualizer *visualizer, bool deleteVisualizer)
+{
+    if(this->visualizer != 0x0 && this->deleteVisualizer)
+        delete this->visualizer;
+
+    this->visualizer = visualizer;
+    this->deleteVisualizer = deleteVisualizer;
+}
+
+/**
+ * @brief Take the descriptors of new frames from arena
+ * (or 0x0 to allocate each one). The arena owns them, so
+ * they aren't deleted by clearDescriptors.
+ *  It must be set before describing any frame.
+ */
+void Sonar::setDescriptorArena(DescriptorArena *arena)
+{
+    descriptorArena = arena;
+}
+
+SonarDescritor *Sonar::newDescriptor()
+{
+    if(descriptorArena != 0x0)
+        return descriptorArena->newDescriptor();
+    return new SonarDescritor;
+}
+
+/**
+ * @brief Headless description of a 16 bits sonar image.
+ *  It doesn't draw, write files or match the new description
+ * with previous ones, and the descriptor isn't stored by Sonar,
+ * so the caller must delete it (unless it came from a DescriptorArena).
+ *
+ * @param img16bits - 16 bits sonar image.
+ * @return SonarDescritor - New frame descriptor.
+ */
+SonarDescritor *Sonar::describe(Mat &img16bits)
+{
+    SonarDescritor *sd = newDescriptor();
+
+    createGaussian(img16bits, sd);
+    createGraph(sd);
+
+    return sd;
+}
+
 SonarDescritor *Sonar::newImage(Mat img)
 {
     cronometer.reset();
@@ -420,12 +515,9 @@ SonarDescritor *Sonar::newImage(Mat img)
     // Save reference to 16bits image
     img16bits = img;
 
-    // Reset Color Mat for new draws
-    colorImg = Mat::zeros(img16bits.rows,img16bits.cols, CV_8UC3);
-
     cout << "PDI:: Using Threshold = " << (unsigned) segmentation.pixelThreshold << endl;
 
-    SonarDescritor *sd = new SonarDescritor;
+    SonarDescritor *sd = newDescriptor();
 
     createGaussian(img16bits, sd);
 
@@ -434,110 +526,15 @@ SonarDescritor *Sonar::newImage(Mat img)
     else if(graphCreatorMode == FIXED_DISTANCE)
         createGraph(sd);
 
-    char fileName[200];
-
-    // LSB IMAGE
-    Mat LSBImg;
-    //    subtract(img,0,img);
-    img16bits.convertTo(LSBImg,CV_8U);
-
-    if(saveTruncateImg)
-    {
-    sprintf(fileName,"frame_%.5d_8bitsTrucate.png", descriptors.size());
-    imwrite(fileName, LSBImg);
-    }
-
-    if(storeImgs)
-        storedImgs.push_back(LSBImg);
-
-    resize(LSBImg,LSBImg,Size(800,600));
-    imshow("Least Significant Bit Truncate Image", LSBImg);
-
-    img16bits.convertTo(colorImg,CV_8U);
-    cvtColor(colorImg,colorImg,CV_GRAY2BGR);
-
-    imwrite("f4a.png", colorImg);
-    drawGaussians(colorImg,sd);
-    imwrite("f4b.png", colorImg);
-
-    if(saveGraphImg)
-    {
-    sprintf(fileName,"frame_%.5d_Graph.png", descriptors.size());
-    imwrite(fileName, colorImg);
-    }
-
-    resize(colorImg,colorImg,Size(800,600));
-    imshow("Color Img", colorImg);
-
     descriptors.push_back(sd);
 
-    if(drawEachVetex)
-    {
-        for(unsigned i = 0 ; i < sd->gaussians.size() ; i ++)
-        {
-            Mat dVertex = Mat::zeros(img.rows, img.cols, CV_8UC3);
-            Drawing::drawVertex(dVertex, sd, i, Rect(0,0,dVertex.cols, dVertex.rows),
-                                       Scalar(0,255,0),Scalar(255,0,255));
-            imshow("Vertex", dVertex);
-            waitKey();
-        }
-    }
-
-    if(descriptors.size() > 1)
-    {
-        for(int frame = descriptors.size()-2; frame >= 0; frame--)
-        {
-           vector<MatchInfo> matches;
-           Mat sdImg1 = Mat::zeros(img.rows,img.cols,CV_8UC3),
-            sdImg2 = Mat::zeros(img.rows,img.cols,CV_8UC3),
-            matchImg = Mat::zeros(img.rows,img.cols,CV_8UC3);
-
-//        matcher.matche(descriptors[descriptors.size()-1], sd,matches);
-           matcher.findMatch(descriptors[frame], sd,matches);
-//        matcher.matcheM(descriptors[frame], sd,matches);
-
-        if(storeImgs)
-            matcher.drawMatchOnImgs(matchImg,Size2i(img.cols*1.2,img.rows),
-                                    descriptors[frame], storedImgs[frame],
-                                    sd, storedImgs[descriptors.size()-1],
-                                    matches);
-        else
-            matcher.drawMatch(descriptors[frame], sd,matches, matchImg);
-
-        drawGaussians(sdImg1,descriptors[frame]);
-        drawGaussians(sdImg2,sd);
-
-//        SonarDescritor::drawDescriptor(sdImg1,descriptors[descriptors.size()-1]);
-//        SonarDescritor::drawDescriptor(sdImg2,sd);
-
-        if(saveMatchImgs)
-        {
-        sprintf(fileName,"frame_%.5d-%.5d_Graph_1.png", descriptors.size()-1, descriptors.size());
-        imwrite(fileName, sdImg1);
-
-        sprintf(fileName,"frame_%.5d-%.5d_Graph_2.png", descriptors.size()-1, descriptors.size());
-        imwrite(fileName, sdImg2);
-
-        sprintf(fileName,"frame_%.5d-%.5d_Match.png", descriptors.size()-1, descriptors.size());
-        imwrite(fileName, matchImg);
-        }
-
-        resize(sdImg1,sdImg1,Size(800,600));
-        imshow("SD before", sdImg1);
+    cout << "Execution time = " << cronometer.read() << " usec" << endl;
 
-        resize(sdImg2,sdImg2,Size(800,600));
-        imshow("SD after", sdImg2);
+    if(visualizer == 0x0)
+        setVisualizer(new HighGuiSonarVisualizer);
 
-        resize(matchImg,matchImg,Size(1400,600));
-        imshow("Graph Match", matchImg);
+    visualizer->newDescriptor(*this,img16bits,sd,descriptors);
 
-//            if(descriptors.size()%10 != 0)
-                break;
-            waitKey();
-        }
-    }
-
-    cout << "Execution time = " << cronometer.read() << " usec" << endl;
     return sd;
 }
 
@@ -550,7 +547,7 @@ SonarDescritor *Sonar::newImageDebug(Mat &imgGray16bits, Mat &bgr_imgResult)
 
     cout << "PDI:: Using Threshold = " << (unsigned) segmentation.pixelThreshold << endl;
 
-    SonarDescritor *sd = new SonarDescritor;
+    SonarDescritor *sd = newDescriptor();
 
     createGaussian(img16bits, sd);
 
@@ -572,25 +569,13 @@ SonarDescritor *Sonar::newImageDebug(Mat &imgGray16bits, Mat &bgr_imgResult)
 
 SonarDescritor *Sonar::newImageDirect(Mat &img)
 {
-    cronometer.reset();
-
     // Save reference to 16bits image
     img16bits = img;
 
-    cout << "PDI:: Using Threshold = " << (unsigned) segmentation.pixelThreshold << endl;
-
-    SonarDescritor *sd = new SonarDescritor;
-
-    createGaussian(img16bits, sd);
-
-//    if(graphCreatorMode == CLOSEST_NEIGHBOR_RELATIVE_DISTANCE)
-//        createGraphNeighborRelative(sd);
-//    else if(graphCreatorMode == FIXED_DISTANCE)
-    createGraph(sd);
+    SonarDescritor *sd = describe(img16bits);
 
     descriptors.push_back(sd);
 
-    cout << "Execution time = " << cronometer.read() << " usec" << endl;
     return sd;
 }
 
@@ -627,6 +612,7 @@ void Sonar::setStoreImgs(bool store)
 
 void Sonar::clearDescriptors()
 {
+    if(descriptorArena == 0x0)
     for(unsigned i = 0 ; i < descriptors.size() ; i++)
     {
         delete descriptors[i];
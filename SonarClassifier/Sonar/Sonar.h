@@ -11,10 +11,12 @@
 #include "SonarConfig/ConfigLoader.h"
 #include "GraphLink.h"
 #include "SonarDescritor.h"
+#include "DescriptorArena.h"
 #include "GraphMatcher/GraphMatcher.h"
 #include "Cronometer.h"
 
 #include "Segmentation/Segmentation.h"
+#include "SonarVisualizer.h"
 
 using namespace std;
 using namespace cv;
@@ -39,11 +41,12 @@ private:
     GraphCreatorMode graphCreatorMode;
 
     Mat img16bits;
-    Mat colorImg;
 
     vector<SonarDescritor*> descriptors;
+    DescriptorArena *descriptorArena; // If not null, new descriptors come from it
 
-    vector<Mat> storedImgs;
+    SonarVisualizer *visualizer;
+    bool deleteVisualizer;
 
 
 public:
@@ -83,6 +86,8 @@ public:
     void createGraph(SonarDescritor *sd);
     void createGraphNeighborRelative(SonarDescritor *sd);
 
+    SonarDescritor *newDescriptor();
+
 public:
     Sonar(ConfigLoader &config, bool deleteDescriptors=true);
     Sonar(bool deleteDescriptors=true);
@@ -90,6 +95,12 @@ public:
 
     void loadConfig(ConfigLoader &config);
 
+    void setVisualizer(SonarVisualizer *visualizer, bool deleteVisualizer=true);
+
+    void setDescriptorArena(DescriptorArena *arena);
+
+    SonarDescritor* describe(Mat &img16bits);
+
     SonarDescritor* newImage(Mat img);
 
     SonarDescritor* newImageDebug(Mat &imgGray16bits, Mat &imgResult);
@@ -2,8 +2,10 @@
 #include <cfloat>
 #include <iostream>
 #include <cstdio>
+#include <algorithm>
 
 #include "Drawing/Drawing.h"
+#include "GaussianGrid.h"
 
 using namespace std;
 
@@ -12,9 +14,46 @@ SonarDescritor::SonarDescritor():
 {
 }
 
+SonarDescritor::SonarDescritor(const SonarDescritor &sd):
+    gaussians(sd.gaussians),
+    vertices(sd.vertices),
+    x(sd.x),y(sd.y),ang(sd.ang)
+{
+    copyGraph(sd);
+}
+
 SonarDescritor::~SonarDescritor()
 {
-    clearGraph();
+}
+
+SonarDescritor &SonarDescritor::operator=(const SonarDescritor &sd)
+{
+    if(this != &sd)
+    {
+        gaussians = sd.gaussians;
+        vertices = sd.vertices;
+        x = sd.x; y = sd.y; ang = sd.ang;
+        copyGraph(sd);
+    }
+    return *this;
+}
+
+/**
+ * @brief Copy the graph of sd, vertex of the copy
+ * point to its own links storage.
+ */
+void SonarDescritor::copyGraph(const SonarDescritor &sd)
+{
+    links = sd.links;
+    edges = sd.edges;
+
+    graph.resize(sd.graph.size());
+    for(unsigned i = 0 ; i < graph.size(); i++)
+    {
+        graph[i].resize(sd.graph[i].size());
+        for(unsigned j = 0 ; j < graph[i].size(); j++)
+            graph[i][j] = &links[sd.graph[i][j] - &sd.links[0]];
+    }
 }
 
 /**
@@ -27,73 +66,175 @@ void SonarDescritor::clearLinks()
     {
         graph[gi].clear();
     }
+    links.clear();
+    edges.build(graph);
 }
 
+/**
+ * @brief Clear the graph, buffers of vertex, links and
+ * CSR edges are kept to the next graph.
+ */
 void SonarDescritor::clearGraph()
 {
+    if(vertexBuffers.size() < graph.size())
+        vertexBuffers.resize(graph.size());
+
     for(unsigned i = 0 ; i < graph.size(); i++)
     {
-        for(unsigned j = 0 ; j < graph[i].size(); j++)
-            delete graph[i][j];
+        graph[i].clear();
+        if(graph[i].capacity() > vertexBuffers[i].capacity())
+            graph[i].swap(vertexBuffers[i]);
     }
 
     graph.clear();
+    links.clear();
+    edges.clear();
 }
 
 void SonarDescritor::clearGaussian()
 {
     gaussians.clear();
+    vertices.clear();
+    mergeIndex.clear();
+}
+
+/**
+ * @brief Copy gaussians to the packed vertices table, needed
+ * after gaussians is written directly (not by addGaussian).
+ */
+void SonarDescritor::updateVertices()
+{
+    vertices.assign(gaussians.begin(), gaussians.end());
+}
+
+/**
+ * @brief Leave the descriptor as a new one, keeping
+ * its memory (used by DescriptorArena).
+ */
+void SonarDescritor::reset()
+{
+    clearGraph();
+    clearGaussian();
+    x = y = ang = 0.f;
+}
+
+/**
+ * @brief Clear the graph and create nVertex vertex without
+ * edges, reusing the buffers of previous graphs vertex.
+ */
+void SonarDescritor::resizeGraph(unsigned nVertex)
+{
+    clearGraph();
+    graph.resize(nVertex);
+
+    unsigned nBuffers = min(nVertex, (unsigned) vertexBuffers.size());
+    for(unsigned i = 0 ; i < nBuffers; i++)
+        graph[i].swap(vertexBuffers[i]);
 }
 
 
 /**
  * @brief Create a symetric graph linking vertex with
- * distances lower than graphLinkDistance.
+ * distances lower than graphLinkDistance, candidate
+ * pairs come from a GaussianGrid (near linear).
+ *  All links are allocated on one block (links), the
+ * CSR index (edges) is rebuilt at the end. It reads only the
+ * packed vertices, updated from gaussians at start.
  *
  * @param graphLinkDistance
  */
 void SonarDescritor::createGraph(float graphLinkDistance, bool direct)
 {
-    graph.clear();
-    graph.resize(gaussians.size());
+    updateVertices();
+    unsigned nG = vertices.size();
+
+    // Only Gaussians on neighbor cells of the grid are tested
+    GaussianGrid grid;
+    grid.build(vertices, graphLinkDistance);
+    vector<unsigned> candidates, linked;
+
+    // Vertex i links to pairDest[pairBegin[i] , pairBegin[i+1]), all > i
+    vector<unsigned> pairBegin(nG+1,0), pairDest, degree(nG,0);
 
-    for(unsigned i = 0 ; i < gaussians.size() ; i++)
+    for(unsigned i = 0 ; i < nG ; i++)
     {
-        float cx = gaussians[i].x,
-              cy = gaussians[i].y;
+        float cx = vertices[i].x,
+              cy = vertices[i].y;
 
-        for(unsigned j = i+1 ; j < gaussians.size() ; j++)
+        grid.candidates(cx, cy, candidates);
+
+        linked.clear();
+        for(unsigned k = 0 ; k < candidates.size() ; k++)
+        {
+            unsigned j = candidates[k];
+            float dx = vertices[j].x-cx, dy = vertices[j].y-cy;
+
+            if(j > i && sqrt(dx*dx + dy*dy) <= graphLinkDistance)
+                linked.push_back(j);
+        }
+
+        // Links are created in id order, as testing all pairs
+        sort(linked.begin(), linked.end());
+
+        pairDest.insert(pairDest.end(), linked.begin(), linked.end());
+        pairBegin[i+1] = pairDest.size();
+
+        degree[i]+= linked.size();
+        if(direct)
+        {
+            for(unsigned k = 0 ; k < linked.size() ; k++)
+                degree[linked[k]]++;
+        }
+    }
+
+    // graph vertex point to links, it can't be reallocated below
+    resizeGraph(nG);
+    links.resize(direct ? 2*pairDest.size() : pairDest.size());
+    for(unsigned i = 0 ; i < nG ; i++)
+        graph[i].reserve(degree[i]);
+
+    unsigned l = 0;
+    for(unsigned i = 0 ; i < nG ; i++)
+    {
+        float cx = vertices[i].x,
+              cy = vertices[i].y;
+
+        for(unsigned k = pairBegin[i] ; k < pairBegin[i+1] ; k++)
         {
-            float x = gaussians[j].x,
-                  y = gaussians[j].y,
+            unsigned j = pairDest[k];
+
+            float x = vertices[j].x,
+                  y = vertices[j].y,
                   dx=x-cx, dy=y-cy,
                   d = sqrt(dx*dx + dy*dy);
 
-            if(d <= graphLinkDistance)
-            {
-                float dt = 180.f*atan2f(dx,-dy)/M_PI, edt;
-                if(dt<0.f) dt+=360.f;
+            float dt = 180.f*atan2f(dx,-dy)/M_PI, edt;
+            if(dt<0.f) dt+=360.f;
 
-                edt = dt - gaussians[i].ang;
-                if(edt < 0.f) edt += 360.f;
+            edt = dt - vertices[i].ang;
+            if(edt < 0.f) edt += 360.f;
 
-                graph[i].push_back(new GraphLink(dt,edt,0.f, d,j));
+            links[l] = GraphLink(dt,edt,0.f, d,j);
+            graph[i].push_back(&links[l++]);
 
-                if(direct)
-                {
-                if(dt > 180.f) dt-=180.f;
-                else dt+= 180.f;
+            if(direct)
+            {
+            if(dt > 180.f) dt-=180.f;
+            else dt+= 180.f;
 
-                edt = dt - gaussians[j].ang;
-                if(edt < 0.f) edt += 360.f;
+            edt = dt - vertices[j].ang;
+            if(edt < 0.f) edt += 360.f;
 
-                graph[j].push_back(new GraphLink(dt,edt,0,d,i));
-                }
+            links[l] = GraphLink(dt,edt,0,d,i);
+            graph[j].push_back(&links[l++]);
             }
         }
 
+        // Vertex i don't receive links from j > i
         GraphLink::computeInvAng(graph[i]);
     }
+
+    edges.build(graph);
 }
 
 void SonarDescritor::createGraphNeighborRelative(float graphNeigborDistanceRelativeLink)
@@ -173,34 +314,86 @@ float sqrt_dist(Point2f &p1, Point2f &p2)
     return dx*dx - dy*dy;
 }
 
+/**
+ * @brief Add a Gaussian, or merge it with the last Gaussian
+ * it intersects. Merge candidates come from mergeIndex, rebuilt
+ * when gaussians were changed without addGaussian (merge=true).
+ * The vertices table follows the change.
+ */
 void SonarDescritor::addGaussian(const Gaussian &g, bool merge)
 {
     bool merged = false;
 
     if(merge)
-    for(int i = gaussians.size()-1 ; i >= 0; i--)
     {
-//        cout << "Intersectio test " << gaussians.size() << " - " << i << endl;
-        if(Gaussian::hasIntersection(g,gaussians[i]))
-        {
-            cout << "Merge with " << i << endl;
+        if(mergeIndex.size() != gaussians.size())
+            mergeIndex.build(gaussians);
+
+        vector<unsigned> candidates;
+        mergeIndex.candidates(g,candidates);
 
-            gaussians[i].merge(g,1.f);
-            merged = true;
-            break;
+        for(unsigned k = 0 ; k < candidates.size(); k++)
+        {
+            unsigned i = candidates[k];
+//            cout << "Intersectio test " << gaussians.size() << " - " << i << endl;
+            if(Gaussian::hasIntersection(g,gaussians[i]))
+            {
+                cout << "Merge with " << i << endl;
+
+                gaussians[i].merge(g,1.f);
+                mergeIndex.update(i,gaussians[i]);
+                if(i < vertices.size())
+                    vertices[i] = gaussians[i];
+                merged = true;
+                break;
+            }
         }
     }
 
     if(!merged)
+    {
         gaussians.push_back(g);
+        if(merge) mergeIndex.add(g);
+    }
+
+    if(vertices.size() + (merged ? 0 : 1) == gaussians.size())
+    {
+        if(!merged) vertices.push_back(g);
+    }else updateVertices();
 }
 
 unsigned SonarDescritor::numberOfEdges()
 {
-    unsigned nE = 0u;
-    for(unsigned i = 0u; i < graph.size() ; i++)
-    {
-        nE += graph[i].size();
-    }
-    return nE;
+    return edges.numberOfEdges();
+}
+
+/**
+ * @brief Edge signature of vertex v (GraphEdges::byLength),
+ * 0x0 if the CSR doesn't describe graph[v].
+ */
+const unsigned *SonarDescritor::edgesByLength(unsigned v) const
+{
+    if(v >= graph.size() || v >= edges.numberOfVertex() ||
+       edges.degree(v) != graph[v].size())
+        return 0x0;
+    return edges.byLength(v);
+}
+
+/**
+ * @brief Bytes reserved by the descriptor buffers.
+ */
+size_t SonarDescritor::capacity() const
+{
+    size_t total = gaussians.capacity()*sizeof(Gaussian) +
+                   vertices.capacity()*sizeof(GaussianVertex) +
+                   links.capacity()*sizeof(GraphLink) +
+                   edges.capacity() +
+                   (graph.capacity() + vertexBuffers.capacity())*sizeof(vector<GraphLink*>);
+
+    for(unsigned i = 0 ; i < graph.size(); i++)
+        total+= graph[i].capacity()*sizeof(GraphLink*);
+    for(unsigned i = 0 ; i < vertexBuffers.size(); i++)
+        total+= vertexBuffers[i].capacity()*sizeof(GraphLink*);
+
+    return total;
 }
@@ -8,7 +8,10 @@
 #include<vector>
 #include "Segmentation/Segmentation.h"
 #include"Gaussian.h"
+#include "GaussianVertex.h"
+#include "GaussianBroadPhase.h"
 #include"GraphLink.h"
+#include "GraphEdges.h"
 #include "GraphMatcher/MatchInfo/MatchInfoExtended.h"
 
 using namespace std;
@@ -25,21 +28,33 @@ class SonarDescritor
 {
 public:
     vector<Gaussian> gaussians;
+    vector<GaussianVertex> vertices; /**< Packed copy of gaussians, kept by addGaussian, clearGaussian and createGraph */
     vector<vector<GraphLink*> > graph;/**< This is our graph representatation, a vector of vertex */
+    vector<GraphLink> links; /**< Storage of all graph links, graph vertex point to it */
+    GraphEdges edges; /**< CSR index of graph, edge lengths and length signatures */
 
     // Currently we are not using this attributes.
     float x, y, ang; /**< This attributes are about frame allingment */
 
     SonarDescritor();
+    SonarDescritor(const SonarDescritor &sd);
 
     ~SonarDescritor();
 
+    SonarDescritor& operator=(const SonarDescritor &sd);
+
     void clearLinks();
 
     void clearGraph();
 
     void clearGaussian();
 
+    void reset();
+
+    void updateVertices();
+
+    void resizeGraph(unsigned nVertex);
+
     void createGraph(float graphLinkDistance, bool direct=true);
 
     void createGraphNeighborRelative(float graphNeigborDistanceRelativeLink);
@@ -47,6 +62,17 @@ public:
     void addGaussian(const Gaussian &g, bool merge=false);
 
     unsigned numberOfEdges();
+
+    const unsigned *edgesByLength(unsigned v) const;
+
+    size_t capacity() const;
+
+private:
+    GaussianBroadPhase mergeIndex; // Merge candidates of addGaussian
+
+    vector<vector<GraphLink*> > vertexBuffers; // Edges lists of cleared vertex, reused by resizeGraph
+
+    void copyGraph(const SonarDescritor &sd);
 };
 
 #endif // SONARDESCRITOR_H
@@ -0,0 +1,39 @@
+#ifndef SONARVISUALIZER_H
+#define SONARVISUALIZER_H
+
+#include <opencv2/core/core.hpp>
+
+#include <vector>
+
+#include "SonarDescritor.h"
+
+using namespace std;
+using namespace cv;
+
+class Sonar;
+
+/**
+ * @brief Opt-in sink of Sonar frame descriptions.
+ *  Sonar::describe() never draws anything, all drawing,
+ * windows and image writing of Sonar::newImage() are done by
+ * a SonarVisualizer, so batch processing can run without X11.
+ */
+class SonarVisualizer
+{
+public:
+    virtual ~SonarVisualizer(){}
+
+    /**
+     * @brief Called by Sonar::newImage() after a new frame is described.
+     *
+     * @param sonar - Sonar that described the frame (draw flags and matcher).
+     * @param img16bits - Described 16 bits image.
+     * @param sd - New descriptor, it's the last one of descriptors.
+     * @param descriptors - All descriptors created by sonar.
+     */
+    virtual void newDescriptor(Sonar &sonar, Mat &img16bits,
+                               SonarDescritor *sd,
+                               const vector<SonarDescritor*> &descriptors) = 0;
+};
+
+#endif // SONARVISUALIZER_H
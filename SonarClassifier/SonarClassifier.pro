@@ -3,6 +3,10 @@ CONFIG += console
 CONFIG -= app_bundle
 CONFIG -= qt
 
+# Vectorized beam peak detection (BeamPeakDetector)
+contains(QMAKE_HOST.arch, x86_64): QMAKE_CXXFLAGS += -msse4.1
+#contains(QMAKE_HOST.arch, x86_64): QMAKE_CXXFLAGS += -mavx2
+
 #LIBS += `pkg-config --cflags --libs opencv` -L/usr/local/lib/
 #LIBS += -I/usr/local/include/opencv -I/usr/local/include/opencv2 -L/usr/local/lib/ -lopencv_core -lopencv_imgproc -lopencv_highgui -lopencv_ml -lopencv_video -lopencv_features2d -lopencv_calib3d -lopencv_objdetect -lopencv_contrib -lopencv_legacy -I /usr/local/lib/
 
@@ -35,6 +39,11 @@ SOURCES += main.cpp \
     WindowTool/WindowFeature.cpp \
     Sonar/Sonar.cpp \
     Sonar/SonarDescritor.cpp \
+    Sonar/GaussianGrid.cpp \
+    Sonar/GaussianVertex.cpp \
+    Sonar/GaussianBroadPhase.cpp \
+    Sonar/GraphEdges.cpp \
+    Sonar/DescriptorArena.cpp \
     Sonar/GraphLink.cpp \
     Sonar/GaussianTest.cpp \
     Sonar/Gaussian.cpp \
@@ -108,6 +117,7 @@ SOURCES += main.cpp \
     Tools/CircularQueue.cpp \
     GraphMatcher/GraphMatchFinder/GMFByEdgeExploration.cpp \
     GraphMatcher/GraphMatchFinder/GMFBestDirect.cpp \
+    GraphMatcher/GraphMatchFinder/VertexSignatureIndex.cpp \
     Tools/ModelEvaluation.cpp \
     Tools/GenericImageProcessing.cpp \
     Tools/DirOperations.cpp \
@@ -134,7 +144,21 @@ SOURCES += main.cpp \
     WindowTool/WFFeatureDescriptor/SVMClassifier.cpp \
     WindowTool/WFFeatureDescriptor/RandomForestClassifier.cpp \
     WindowTool/WFFeatureDescriptor/KNearestClassifier.cpp \
-    Tools/CorrelationMatrix.cpp
+    Tools/CorrelationMatrix.cpp \
+    CloseLoop/LoopClosureEngine.cpp \
+    CloseLoop/FrameCandidateIndex.cpp \
+    CloseLoop/OnlineLoopClosure.cpp \
+    CloseLoop/MatchResultStore.cpp \
+    Sonar/DescriptorArchive.cpp \
+    Sonar/HighGuiSonarVisualizer.cpp \
+    Sonar/FramePipeline.cpp \
+    Segmentation/SegmentSearcher/BeamLUT.cpp \
+    Segmentation/SegmentSearcher/BeamPeakDetector.cpp \
+    Segmentation/FloodFillQueue.cpp \
+    Segmentation/SearchMask.cpp \
+    Segmentation/SegmentArena.cpp \
+    Segmentation/SegmentPixels.cpp \
+    Segmentation/SegmentMoments.cpp
 
 
 
@@ -156,6 +180,11 @@ HEADERS += \
     Sonar/Sonar.h \
     Sonar/GraphLink.h \
     Sonar/SonarDescritor.h \
+    Sonar/GaussianGrid.h \
+    Sonar/GaussianVertex.h \
+    Sonar/GaussianBroadPhase.h \
+    Sonar/GraphEdges.h \
+    Sonar/DescriptorArena.h \
     Sonar/Gaussian.h \
     Sonar/GaussianTest.h \
     WindowTool/SonarTestWindow.h \
@@ -229,6 +258,7 @@ HEADERS += \
     Tools/CircularQueue.h \
     GraphMatcher/GraphMatchFinder/GMFByEdgeExploration.h \
     GraphMatcher/GraphMatchFinder/GMFBestDirect.h \
+    GraphMatcher/GraphMatchFinder/VertexSignatureIndex.h \
     Tools/ModelEvaluation.h \
     Tools/GenericImageProcessing.h \
     Tools/DirOperations.h \
@@ -255,7 +285,24 @@ HEADERS += \
     WindowTool/WFFeatureDescriptor/SVMClassifier.h \
     WindowTool/WFFeatureDescriptor/RandomForestClassifier.h \
     WindowTool/WFFeatureDescriptor/KNearestClassifier.h \
-    Tools/CorrelationMatrix.h
+    Tools/CorrelationMatrix.h \
+    CloseLoop/LoopClosureEngine.h \
+    CloseLoop/FrameCandidateIndex.h \
+    CloseLoop/OnlineLoopClosure.h \
+    CloseLoop/MatchResultStore.h \
+    Sonar/DescriptorArchive.h \
+    Sonar/SonarVisualizer.h \
+    Sonar/HighGuiSonarVisualizer.h \
+    Sonar/FramePipeline.h \
+    Tools/BoundedQueue.h \
+    Segmentation/SegmentSearcher/BeamLUT.h \
+    Segmentation/SegmentSearcher/BeamPeakDetector.h \
+    Segmentation/FloodFillQueue.h \
+    Segmentation/FloodFill.h \
+    Segmentation/SearchMask.h \
+    Segmentation/SegmentArena.h \
+    Segmentation/SegmentPixels.h \
+    Segmentation/SegmentMoments.h
 
 OTHER_FILES += \
     MachadosConfig \
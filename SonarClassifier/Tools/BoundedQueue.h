@@ -0,0 +1,79 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <deque>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+ * @brief Blocking FIFO with fixed capacity used to connect
+ * pipeline stages. push() waits while the queue is full and
+ * pop() waits while it's empty, after close() pop() returns
+ * the remaining elements and then false.
+ */
+template <class T>
+class BoundedQueue
+{
+    std::deque<T> m_q;
+    unsigned m_capacity;
+    bool m_closed;
+
+    boost::mutex m_mtx;
+    boost::condition_variable m_notFull, m_notEmpty;
+
+public:
+    BoundedQueue(unsigned capacity=16):
+        m_capacity(capacity > 0 ? capacity : 1), m_closed(false){}
+
+    void reset(unsigned capacity)
+    {
+        boost::mutex::scoped_lock lock(m_mtx);
+        m_q.clear();
+        m_capacity = capacity > 0 ? capacity : 1;
+        m_closed = false;
+    }
+
+    /**
+     * @return false if the queue was closed and v wasn't inserted.
+     */
+    bool push(const T &v)
+    {
+        boost::mutex::scoped_lock lock(m_mtx);
+        while(m_q.size() >= m_capacity && !m_closed)
+            m_notFull.wait(lock);
+
+        if(m_closed) return false;
+
+        m_q.push_back(v);
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @return false if the queue is closed and empty.
+     */
+    bool pop(T &v)
+    {
+        boost::mutex::scoped_lock lock(m_mtx);
+        while(m_q.empty() && !m_closed)
+            m_notEmpty.wait(lock);
+
+        if(m_q.empty()) return false;
+
+        v = m_q.front();
+        m_q.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        boost::mutex::scoped_lock lock(m_mtx);
+        m_closed = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+};
+
+#endif // BOUNDEDQUEUE_H
@@ -1,180 +1,277 @@
 #include "HungarianAlgorithm.h"
 #include "GraphMatcher/MatchInfo/MatchInfoWeighted.h"
 
-#include <cstdio>
-#include <cstring>
-#include <cstdlib>
-#include <cmath>
+#include <algorithm>
+#include <functional>
 #include <iostream>
 
 using namespace std;
 
+typedef pair<double,unsigned> PDU;
 
-void HungarianAlgorithm::init_labels()
+HungarianAlgorithm::HungarianAlgorithm():
+    m_rows(0), m_cols(0), m_unassignedCost(0.f)
 {
-    memset(lx, 0, sizeof(lx));
-    memset(ly, 0, sizeof(ly));
-    for (int x = 0; x < n; x++)
-    for (int y = 0; y < n; y++)
-        lx[x] = max(lx[x], cost[x][y]);
+}
 
+/**
+ * @brief Remove all entries, buffers are kept.
+ */
+void HungarianAlgorithm::clear()
+{
+    setup(0,0);
 }
 
-void HungarianAlgorithm::augment()
+/**
+ * @brief Start a new rows x cols problem without entries.
+ * @param unassignedCost - Cost of a row without column.
+ */
+void HungarianAlgorithm::setup(unsigned rows, unsigned cols, float unassignedCost)
 {
-    if (max_match == n) return; //check wether matching is already perfect
+    m_rows = rows;
+    m_cols = cols;
+    m_unassignedCost = unassignedCost;
 
-    int x, y, root; //just counters and root vertex
-    int q[HA_N], wr = 0, rd = 0; //q - queue for bfs, wr,rd - write and read
-    //pos in queue
+    m_entryRow.clear();
+    m_entryCol.clear();
+    m_entryCost.clear();
+}
 
-    memset(S, false, sizeof(S)); //init set S
-    memset(T, false, sizeof(T)); //init set T
-    memset(prev, -1, sizeof(prev)); //init set prev - for the alternating tree
+/**
+ * @brief Allow the assignment of row to col with this cost,
+ * when an entry is repeated the lowest cost is used.
+ */
+void HungarianAlgorithm::setCost(unsigned row, unsigned col, float cost)
+{
+    if(row >= m_rows || col >= m_cols)
+    {
+        cout << "HungarianAlgorithm: Invalid entry (" << row << " , " << col << ")!" << endl;
+        return;
+    }
 
-    for (x = 0; x < n; x++) //finding root of the tree
-        if (xy[x] == -1)
-        {
-            q[wr++] = root = x;
-            prev[x] = -2;
-            S[x] = true;
-            break;
-        }
+    m_entryRow.push_back(row);
+    m_entryCol.push_back(col);
+    m_entryCost.push_back(cost);
+}
+
+unsigned HungarianAlgorithm::rows() const
+{
+    return m_rows;
+}
+
+unsigned HungarianAlgorithm::cols() const
+{
+    return m_cols;
+}
+
+/**
+ * @brief Counting sort of entries by row (CSR), keeping
+ * the order they were added.
+ */
+void HungarianAlgorithm::buildRows()
+{
+    unsigned nE = m_entryRow.size();
 
-    for (y = 0; y < n; y++) //initializing slack array
+    m_rowBegin.assign(m_rows+1,0);
+    for(unsigned e = 0 ; e < nE ; e++)
+        m_rowBegin[m_entryRow[e]+1]++;
+
+    for(unsigned r = 1 ; r <= m_rows ; r++)
+        m_rowBegin[r]+= m_rowBegin[r-1];
+
+    m_touched.assign(m_rowBegin.begin(), m_rowBegin.end()-1); // Fill positions
+    m_col.resize(nE);
+    m_cost.resize(nE);
+    for(unsigned e = 0 ; e < nE ; e++)
+    {
+        unsigned k = m_touched[m_entryRow[e]]++;
+        m_col[k] = m_entryCol[e];
+        m_cost[k] = m_entryCost[e];
+    }
+    m_touched.clear();
+}
+
+/**
+ * @brief Column col is reached from row with distance dist,
+ * by an entry with this cost.
+ */
+void HungarianAlgorithm::reach(unsigned col, double dist, unsigned row, float cost)
+{
+    if(m_state[col] == 2) return;
+
+    if(m_state[col] == 0)
+    {
+        m_state[col] = 1;
+        m_touched.push_back(col);
+    }else if(dist >= m_dist[col])
     {
-        slack[y] = lx[root] + ly[y] - cost[root][y];
-        slackx[y] = root;
+        return;
     }
 
-    //second part of augment() function
-    while (true) //main cycle
+    m_dist[col] = dist;
+    m_pred[col] = row;
+    m_predCost[col] = cost;
+
+    m_heap.push_back(PDU(dist,col));
+    push_heap(m_heap.begin(), m_heap.end(), greater<PDU>());
+}
+
+/**
+ * @brief Assign row by the shortest augmenting path, a
+ * Dijkstra search over reduced costs
+ *  cost(i,j) + rowPot[i] - colPot[j] >= 0
+ * that stops on the first free column found.
+ */
+void HungarianAlgorithm::augment(unsigned row)
+{
+    unsigned i = row, freeCol;
+    double di = 0.0;
+
+    m_heap.clear();
+
+    while(true)
     {
-        while (rd < wr) //building tree with bfs cycle
+        double base = di + m_rowPot[i];
+
+        for(unsigned k = m_rowBegin[i] ; k < m_rowBegin[i+1] ; k++)
         {
-            x = q[rd++]; //current vertex from X part
-            for (y = 0; y < n; y++) //iterate through all edges in equality graph
-                if (cost[x][y] == lx[x] + ly[y] && !T[y])
-                {
-                    if (yx[y] == -1) break; //an exposed vertex in Y found, so
-                    //augmenting path exists!
-                    T[y] = true; //else just add y to T,
-                    q[wr++] = yx[y]; //add vertex yx[y], which is matched
-                    //with y, to the queue
-                    add_to_tree(yx[y], x); //add edges (x,y) and (y,yx[y]) to the tree
-                }
-
-            if (y < n) break; //augmenting path found!
+            unsigned j = m_col[k];
+            reach(j, base + m_cost[k] - m_colPot[j], i, m_cost[k]);
         }
 
-        if (y < n) break; //augmenting path found!
+        unsigned u = m_cols + i; // Unassigned column of row i
+        reach(u, base + m_unassignedCost - m_colPot[u], i, m_unassignedCost);
 
-        update_labels(); //augmenting path not found, so improve labeling
-        wr = rd = 0;
+        // Closest column not scanned (there is always the
+        // unassigned column of row)
+        unsigned j;
+        do
+        {
+            pop_heap(m_heap.begin(), m_heap.end(), greater<PDU>());
+            j = m_heap.back().second;
+            di = m_heap.back().first;
+            m_heap.pop_back();
+        }while(m_state[j] == 2 || di > m_dist[j]);
 
-        for (y = 0; y < n; y++)
-        //in this cycle we add edges that were added to the equality graph as a
-        //result of improving the labeling, we add edge (slackx[y], y) to the tree if
-        //and only if !T[y] && slack[y] == 0, also with this edge we add another one
-        //(y, yx[y]) or augment the matching, if y was exposed
-            if (!T[y] && slack[y] == 0)
-            {
-                if (yx[y] == -1) //exposed vertex in Y found - augmenting path exists!
-                {
-                    x = slackx[y];
-                    break;
-                }
-                else
-                {
-                    T[y] = true; //else just add y to T,
-                    if (!S[yx[y]])
-                    {
-                        q[wr++] = yx[y]; //add vertex yx[y], which is matched with
-                        //y, to the queue
-                        add_to_tree(yx[y], slackx[y]); //and add edges (x,y) and (y,
-                        //yx[y]) to the tree
-                    }
-                }
-            }
+        m_state[j] = 2;
+
+        if(m_colRow[j] < 0)
+        {
+            freeCol = j;
+            break;
+        }
 
-        if (y < n) break; //augmenting path found!
+        // Assigned entries have reduced cost 0
+        i = m_colRow[j];
     }
 
-    if (y < n) //we found augmenting path!
+    // Update potentials of scanned nodes, reduced costs
+    // keep non negative and the path becomes tight
+    double dFree = m_dist[freeCol];
+    m_rowPot[row]-= dFree;
+    for(unsigned k = 0 ; k < m_touched.size() ; k++)
     {
-        max_match++; //increment matching
-        //in this cycle we inverse edges along augmenting path
-        for (int cx = x, cy = y, ty; cx != -2; cx = prev[cx], cy = ty)
+        unsigned j = m_touched[k];
+        if(m_state[j] == 2)
         {
-            ty = xy[cx];
-            yx[cy] = cx;
-            xy[cx] = cy;
+            double delta = m_dist[j] - dFree;
+            m_colPot[j]+= delta;
+            if(m_colRow[j] >= 0)
+                m_rowPot[m_colRow[j]]+= delta;
         }
-        augment(); //recall function, go to step 1 of the algorithm
+        m_state[j] = 0;
+    }
+    m_touched.clear();
+
+    // Flip the augmenting path
+    unsigned j = freeCol;
+    while(true)
+    {
+        unsigned pi = m_pred[j];
+        int prevCol = m_rowCol[pi];
+
+        m_colRow[j] = pi;
+        m_rowCol[pi] = j;
+        m_rowCost[pi] = m_predCost[j];
+
+        if(pi == row) break;
+        j = prevCol;
     }
 }
 
-void HungarianAlgorithm::update_labels()
+/**
+ * @brief Find the minimum cost assignment.
+ * @param matchs - Assigned (row , column , cost), by row.
+ * @return float - Cost of assigned entries.
+ */
+float HungarianAlgorithm::hungarian(std::vector<MatchInfoWeighted> &matchs)
 {
-    int x, y;
-    float delta = HA_INF; //init delta as infinity
-    for (y = 0; y < n; y++) //calculate delta using slack
-        if (!T[y])
-            delta = min(delta, slack[y]);
+    matchs.clear();
 
-    for (x = 0; x < n; x++) //update X labels
-        if (S[x]) lx[x] -= delta;
+    unsigned nCols = m_cols + m_rows;
 
-    for (y = 0; y < n; y++) //update Y labels
-        if (T[y]) ly[y] += delta;
+    buildRows();
 
-    for (y = 0; y < n; y++) //update slack array
-        if (!T[y])
-            slack[y] -= delta;
-}
+    // Initial potentials with non negative reduced costs, free
+    // columns must share the same potential (0) so the closest
+    // free column is also the cheapest one
+    m_colPot.assign(nCols,0.0);
+    m_rowPot.resize(m_rows);
+    for(unsigned r = 0 ; r < m_rows ; r++)
+    {
+        float minCost = m_unassignedCost;
+        for(unsigned k = m_rowBegin[r] ; k < m_rowBegin[r+1] ; k++)
+            minCost = min(minCost, m_cost[k]);
+        m_rowPot[r] = -minCost;
+    }
 
-void HungarianAlgorithm::add_to_tree(int x, int prevx)
-{
-    S[x] = true; //add x to S
-    prev[x] = prevx; //we need this when augmenting
-    for (int y = 0; y < n; y++) //update slacks, because we add new vertex to S
-        if (lx[x] + ly[y] - cost[x][y] < slack[y])
+    m_dist.resize(nCols);
+    m_pred.resize(nCols);
+    m_predCost.resize(nCols);
+    m_state.assign(nCols,0);
+    m_colRow.assign(nCols,-1);
+    m_rowCol.assign(m_rows,-1);
+    m_rowCost.assign(m_rows,0.f);
+    m_touched.clear();
+
+    // Greedy start, rows take their cheapest column when it
+    // is free (tight entries), the others are augmented
+    for(unsigned r = 0 ; r < m_rows ; r++)
+    {
+        unsigned best = m_cols + r;
+        float bestCost = m_unassignedCost;
+        for(unsigned k = m_rowBegin[r] ; k < m_rowBegin[r+1] ; k++)
         {
-            slack[y] = lx[x] + ly[y] - cost[x][y];
-            slackx[y] = x;
+            if(m_cost[k] < bestCost && m_colRow[m_col[k]] < 0)
+            {
+                best = m_col[k];
+                bestCost = m_cost[k];
+            }
         }
-}
 
-HungarianAlgorithm::HungarianAlgorithm()
-{
-
-}
-
-void HungarianAlgorithm::clear()
-{
-    n = max_match = 0;
-    memset(cost, 0, sizeof(cost[0][0]) * HA_N * HA_N);
-}
+        if(bestCost == (float) -m_rowPot[r])
+        {
+            m_colRow[best] = r;
+            m_rowCol[r] = best;
+            m_rowCost[r] = bestCost;
+        }
+    }
 
-unsigned HungarianAlgorithm::maxVertex()
-{
-    return HA_N;
-}
+    for(unsigned r = 0 ; r < m_rows ; r++)
+    {
+        if(m_rowCol[r] < 0)
+            augment(r);
+    }
 
-int HungarianAlgorithm::hungarian(std::vector<MatchInfoWeighted> &matchs)
-{
-    float ret = 0; //weight of the optimal matching
-    max_match = 0; //number of vertices in current matching
-    memset(xy, -1, sizeof(xy));
-    memset(yx, -1, sizeof(yx));
-    init_labels(); //step 0
-    augment(); //steps 1-3
-
-    for(int x = 0; x < n; x++) //forming answer there
+    float total = 0.f;
+    for(unsigned r = 0 ; r < m_rows ; r++)
     {
-        printf("%d -- %g --> %d\n",x+1, cost[x][xy[x]], xy[x]+1);
-        ret += cost[x][xy[x]];
+        if(m_rowCol[r] >= 0 && (unsigned) m_rowCol[r] < m_cols)
+        {
+            matchs.push_back(MatchInfoWeighted(r, m_rowCol[r], m_rowCost[r]));
+            total+= m_rowCost[r];
+        }
     }
-    printf("answer %g\n", ret);
-    return ret;
+
+    return total;
 }
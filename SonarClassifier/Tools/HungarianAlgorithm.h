@@ -4,44 +4,62 @@
 #include <vector>
 #include "GraphMatcher/MatchInfo/MatchInfoWeighted.h"
 
+using namespace std;
 
 /**
- * @brief Solve the assingment problem in time O(n^3)
+ * @brief Solve the assingment problem between the rows and
+ * columns of a sparse rectangular cost matrix.
  *
+ *  Only the entries given by setCost can be assigned, each row
+ * is assigned to one column at most and a row left unassigned
+ * costs unassignedCost (0 by default, so only entries with
+ * negative cost are worth to assign). The minimum total cost
+ * assignment is found by shortest augmenting paths (Jonker-Volgenant
+ * style): one Dijkstra search over the reduced costs per row,
+ * visiting only the entries of the rows reached, so sparse
+ * matrices are solved much faster than O(n^3).
  *
- * Special thanks for x-ray from topcoder where this
- * code was copied with small modifications.
- *  https://www.topcoder.com/community/data-science/data-science-tutorials/assignment-problem-and-hungarian-algorithm/
- *
+ *  There is no size limit, the buffers are kept between calls
+ * to avoid allocations when solving many matrices.
  */
 class HungarianAlgorithm
 {
 private:
-    #define HA_INF 100000000 //just infinity
-    #define HA_N 55 //max number of vertices in one part
-
-    float lx[HA_N], ly[HA_N]; //labels of X and Y parts
-    int xy[HA_N]; //xy[x] - vertex that is matched with x,
-    int yx[HA_N]; //yx[y] - vertex that is matched with y
-    bool S[HA_N], T[HA_N]; //sets S and T in algorithm
-    float slack[HA_N]; //as in the algorithm description
-    int slackx[HA_N]; //slackx[y] such a vertex, that
-     // l(slackx[y]) + l(y) - w(slackx[y],y) = slack[y]
-    int prev[HA_N]; //array for memorizing alternating paths
-
-    void init_labels();
-    void augment();
-    void update_labels();
-    void add_to_tree(int x, int prevx);
+    unsigned m_rows, m_cols;
+    float m_unassignedCost;
+
+    // Entries added by setCost
+    vector<unsigned> m_entryRow, m_entryCol;
+    vector<float> m_entryCost;
+
+    // Entries by row (CSR)
+    vector<unsigned> m_rowBegin, m_col;
+    vector<float> m_cost;
+
+    // Solver state, columns [m_cols, m_cols+m_rows) are the
+    // unassigned columns of each row
+    vector<double> m_rowPot, m_colPot, m_dist;
+    vector<int> m_colRow, m_rowCol, m_pred;
+    vector<float> m_rowCost, m_predCost;
+    vector<char> m_state; // Column search state, 0 not reached, 1 reached, 2 scanned
+    vector<unsigned> m_touched;
+    vector<pair<double,unsigned> > m_heap;
+
+    void buildRows();
+    void reach(unsigned col, double dist, unsigned row, float cost);
+    void augment(unsigned row);
+
 public:
     HungarianAlgorithm();
 
-    float cost[HA_N][HA_N]; //cost matrix
-    int n, max_match; //n workers and n jobs
-
     void clear();
-    unsigned maxVertex();
-    int hungarian(std::vector<MatchInfoWeighted> &matchs);
+    void setup(unsigned rows, unsigned cols, float unassignedCost=0.f);
+    void setCost(unsigned row, unsigned col, float cost);
+
+    unsigned rows() const;
+    unsigned cols() const;
+
+    float hungarian(std::vector<MatchInfoWeighted> &matchs);
 
 };
 